@@ -0,0 +1,553 @@
+/*
+ ******************************************************************************************
+ * --------------------------------------- SciRooPlot -------------------------------------
+ * Copyright (c) 2019-2026 Mario Krüger
+ * Contact: mario.kruger@cern.ch
+ * For a full list of contributors please see doc/CONTRIBUTORS.md.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation in version 3 (or later) of the License.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * The GNU General Public License can be found here: <https://www.gnu.org/licenses/>.
+ ******************************************************************************************
+ */
+
+#include "SciRooPlot/Helpers.h"
+#include "SciRooPlot/Logging.h"
+#include "SciRooPlot/Plot.h"
+#include "SciRooPlot/PlotManager.h"
+#include "SciRooPlot/PlotPainter.h"
+
+#include <TF1.h>
+#include <TFile.h>
+#include <TGraphErrors.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TH3.h>
+#include <THnSparse.h>
+#include <TMath.h>
+#include <TRandom3.h>
+#include <TTree.h>
+
+#include <boost/program_options.hpp>
+#include <boost/property_tree/info_parser.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+using boost::property_tree::ptree;
+using std::string;
+using std::vector;
+
+using namespace SciRooPlot;
+namespace po = boost::program_options;
+
+//**************************************************************************************************
+/**
+ * Size of the synthetic stress project.
+ */
+//**************************************************************************************************
+struct scale_t {
+  int32_t nDirs;
+  int32_t nSubDirs;
+  int32_t nKeys;  // per sub-directory
+  int32_t nPlots;
+  int32_t nLegendEntries;
+  int64_t nTreeEntries;
+  int64_t nTableRows;
+  int64_t nLargeHistFills;
+
+  int32_t nTotalKeys() const { return nDirs * nSubDirs * nKeys; }
+  // keys are picked with a prime stride to spread the requested data over all directories
+  string KeyName(int64_t i) const
+  {
+    int32_t key = static_cast<int32_t>((i * 7919) % nTotalKeys());
+    return fmt::format("dir{}/sub{}/hist{}", key / (nSubDirs * nKeys), (key / nKeys) % nSubDirs, key % nKeys);
+  }
+};
+
+void GenerateInputFiles(const string& workDir, const scale_t& scale);
+void DefineProject(const string& workDir, const scale_t& scale);
+string format_time(double_t seconds);
+
+namespace SciRooPlot
+{
+//**************************************************************************************************
+/**
+ * Times the numeric kernels of the PlotPainter for increasing numbers of points and bins.
+ */
+//**************************************************************************************************
+class PainterBenchmark
+{
+ public:
+  vector<std::pair<string, double_t>> Run();
+
+ private:
+  template <typename Setup, typename Kernel>
+  static double_t TimeKernel(Setup setup, Kernel kernel, int32_t maxIterations = 1000000);
+
+  PlotPainter mPainter;
+};
+}  // end namespace SciRooPlot
+
+int main(int argc, char* argv[])
+{
+  string workDir;
+  string scaleName;
+  string mode;
+  vector<string> selectedScenarios;
+  string baselineFile;
+  string newBaselineFile;
+  double_t tolerance{};
+  bool regenerate = false;
+
+  try {
+    po::options_description arguments("arguments");
+    arguments.add_options()("help,h", "show this help")("workdir", po::value<string>(&workDir)->default_value("srp_bench"), "directory for the synthetic project, its inputs and outputs")("scale", po::value<string>(&scaleName)->default_value("small"), "size of the synthetic project (small or large)")("mode", po::value<string>(&mode)->default_value("pdf"), "output format of the plots")("scenario", po::value<vector<string>>(&selectedScenarios)->multitoken(), "only run these scenarios")("baseline", po::value<string>(&baselineFile), "compare timings to this baseline")("save-baseline", po::value<string>(&newBaselineFile), "store timings as baseline")("tolerance", po::value<double_t>(&tolerance)->default_value(0.2), "relative slow-down that is reported as regression")("regenerate", "re-create the input files even if they exist");
+    po::positional_options_description pos;
+    pos.add("workdir", 1);
+
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(arguments).positional(pos).run(), vm);
+    po::notify(vm);
+    if (vm.count("help")) {
+      std::cout << "Times plot generation for a synthetic stress project.\n\nUsage: srp_bench [workdir] [options]\n\n"
+                << arguments << std::endl;
+      return 0;
+    }
+    regenerate = vm.count("regenerate");
+  } catch (std::exception& e) {
+    ERROR(R"(Exception "{}"! Exiting.)", e.what());
+    return 1;
+  }
+
+  scale_t scale;
+  if (scaleName == "small") {
+    scale = {10, 10, 100, 1000, 20, 10000000, 1000000, 1000000};
+  } else if (scaleName == "large") {
+    scale = {100, 10, 100, 5000, 50, 100000000, 10000000, 10000000};
+  } else {
+    ERROR("Unknown scale {}.", scaleName);
+    return 1;
+  }
+
+  auto isSelected = [&](const string& scenario) {
+    return selectedScenarios.empty() || std::find(selectedScenarios.begin(), selectedScenarios.end(), scenario) != selectedScenarios.end();
+  };
+  // the kernel microbenchmarks do not need the synthetic project
+  bool needsProject = selectedScenarios.empty() || std::any_of(selectedScenarios.begin(), selectedScenarios.end(), [](const string& scenario) { return scenario != "kernels"; });
+
+  workDir = std::filesystem::absolute(expand_path(workDir)).string() + "/" + scaleName;
+  if (needsProject) {
+    std::filesystem::create_directories(workDir);
+    if (regenerate || !std::filesystem::exists(workDir + "/.generated")) {
+      INFO("Generating synthetic inputs in {}. This may take a while.", workDir);
+      GenerateInputFiles(workDir, scale);
+      std::ofstream(workDir + "/.generated");
+    }
+    DefineProject(workDir, scale);
+  }
+
+  const string plotsFile = workDir + "/plots.info";
+  const string dataSourcesFile = workDir + "/dataSources.info";
+  auto measure = [](const std::function<void()>& run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    return std::chrono::duration<double_t>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  // each scenario starts with a fresh manager, only the warm buffer scenario re-uses the data loaded before
+  vector<std::pair<string, double_t>> timings;
+  if (isSelected("startup")) {
+    // same steps as 'srp plot <group> <name> list', which should stay below 100 ms
+    double_t startupTime = measure([&]() {
+      PlotManager pm;
+      pm.LoadPlots("plot0", "keys", plotsFile);
+      pm.ListPlots();
+    });
+    if (startupTime > 0.1) WARNING("Listing a single plot took {:.0f} ms (target is 100 ms).", 1000. * startupTime);
+    timings.push_back({"startup", startupTime});
+  }
+  if (isSelected("cold_load") || isSelected("warm_buffer")) {
+    PlotManager pm;
+    pm.SetOutputDirectory(workDir + "/output");
+    double_t coldTime = measure([&]() {
+      pm.LoadPlots(".+", "keys", plotsFile);
+      pm.LoadDataSources(dataSourcesFile);
+      pm.GeneratePlots(mode, ".+", "keys");
+    });
+    if (isSelected("cold_load")) timings.push_back({"cold_load", coldTime});
+    if (isSelected("warm_buffer")) timings.push_back({"warm_buffer", measure([&]() { pm.GeneratePlots(mode, ".+", "keys"); })});
+  }
+  for (const auto& [scenario, group] : vector<std::pair<string, string>>{{"ratio_heavy", "ratios"}, {"tree_projections", "trees"}, {"legend_heavy", "legends"}, {"large_objects", "large"}, {"tables", "tables"}}) {
+    if (!isSelected(scenario)) continue;
+    PlotManager pm;
+    pm.SetOutputDirectory(workDir + "/output");
+    timings.push_back({scenario, measure([&, group = group]() {
+                         pm.LoadPlots(".+", group, plotsFile);
+                         pm.LoadDataSources(dataSourcesFile);
+                         pm.GeneratePlots(mode, ".+", group);
+                       })});
+  }
+  if (isSelected("kernels")) {
+    auto kernelTimings = PainterBenchmark().Run();
+    timings.insert(timings.end(), kernelTimings.begin(), kernelTimings.end());
+  }
+
+  ptree baselineTree;
+  if (!baselineFile.empty()) {
+    try {
+      boost::property_tree::read_info(expand_path(baselineFile), baselineTree);
+    } catch (...) {
+      ERROR("Cannot read baseline {}.", baselineFile);
+      return 1;
+    }
+  }
+  bool hasRegression = false;
+  INFO("======================= Benchmark ({}) =======================", scaleName);
+  for (const auto& [scenario, time] : timings) {
+    auto reference = baselineTree.get_optional<double_t>(scenario);
+    if (!reference) {
+      INFO("{:<36} {:>12}", scenario, format_time(time));
+      continue;
+    }
+    double_t change = time / *reference - 1.;
+    bool isRegression = (change > tolerance);
+    hasRegression |= isRegression;
+    INFO("{:<36} {:>12}  (baseline {}, {}{:+.1f}%{})", scenario, format_time(time), format_time(*reference), logger::begin_color(isRegression ? logger::Color::Red : logger::Color::Green), 100. * change, logger::end_color());
+  }
+  INFO("==============================================================");
+
+  if (!newBaselineFile.empty()) {
+    ptree newBaselineTree;
+    for (const auto& [scenario, time] : timings) {
+      newBaselineTree.put(scenario, time);
+    }
+    boost::property_tree::write_info(expand_path(newBaselineFile), newBaselineTree);
+    INFO("Stored timings as baseline in {}.", newBaselineFile);
+  }
+  if (hasRegression) {
+    ERROR("Some scenarios are more than {:.0f}% slower than the baseline.", 100. * tolerance);
+    return 1;
+  }
+  return 0;
+}
+
+//**************************************************************************************************
+/**
+ * Formats a duration with a unit that fits its magnitude.
+ */
+//**************************************************************************************************
+string format_time(double_t seconds)
+{
+  if (seconds >= 1.) return fmt::format("{:.2f} s", seconds);
+  if (seconds >= 1e-3) return fmt::format("{:.2f} ms", seconds * 1e3);
+  return fmt::format("{:.2f} us", seconds * 1e6);
+}
+
+//**************************************************************************************************
+/**
+ * Writes the input files of the stress project: many small histograms in nested directories,
+ * large multi-dimensional histograms, a large tree and a large table.
+ */
+//**************************************************************************************************
+void GenerateInputFiles(const string& workDir, const scale_t& scale)
+{
+  TH1::AddDirectory(false);
+  TRandom3 random(42);
+  {
+    TFile file((workDir + "/keys.root").data(), "RECREATE");
+    for (int32_t dir = 0; dir < scale.nDirs; ++dir) {
+      for (int32_t subDir = 0; subDir < scale.nSubDirs; ++subDir) {
+        file.mkdir(fmt::format("dir{}/sub{}", dir, subDir).data(), "", true)->cd();
+        for (int32_t key = 0; key < scale.nKeys; ++key) {
+          TH1D hist(fmt::format("hist{}", key).data(), "", 100, -5., 5.);
+          double_t mean = random.Uniform(-2., 2.);
+          for (int32_t bin = 1; bin <= hist.GetNbinsX(); ++bin) {
+            double_t x = hist.GetBinCenter(bin);
+            hist.SetBinContent(bin, random.Poisson(1000. * std::exp(-0.5 * (x - mean) * (x - mean))));
+            hist.SetBinError(bin, std::sqrt(hist.GetBinContent(bin)));
+          }
+          hist.Write();
+        }
+      }
+    }
+  }
+  {
+    TFile file((workDir + "/large.root").data(), "RECREATE");
+    TH2D hist2d("hist2d", ";x;y", 2000, -5., 5., 2000, -5., 5.);
+    TH3D hist3d("hist3d", ";x;y;z", 200, -5., 5., 200, -5., 5., 200, -5., 5.);
+    vector<int32_t> nBins(6, 100);
+    vector<double_t> xMin(6, -5.);
+    vector<double_t> xMax(6, 5.);
+    THnSparseD histSparse("histSparse", "", 6, nBins.data(), xMin.data(), xMax.data());
+    vector<double_t> point(6);
+    for (int64_t i = 0; i < scale.nLargeHistFills; ++i) {
+      for (auto& coordinate : point) {
+        coordinate = random.Gaus();
+      }
+      hist2d.Fill(point[0], point[1]);
+      hist3d.Fill(point[0], point[1], point[2]);
+      histSparse.Fill(point.data());
+    }
+    hist2d.Write();
+    hist3d.Write();
+    histSparse.Write();
+  }
+  {
+    TFile file((workDir + "/tree.root").data(), "RECREATE");
+    TTree tree("events", "");
+    Float_t pt, eta, phi;
+    Int_t mult;
+    Double_t weight;
+    tree.Branch("pt", &pt);
+    tree.Branch("eta", &eta);
+    tree.Branch("phi", &phi);
+    tree.Branch("mult", &mult);
+    tree.Branch("weight", &weight);
+    for (int64_t i = 0; i < scale.nTreeEntries; ++i) {
+      pt = static_cast<Float_t>(random.Exp(1.));
+      eta = static_cast<Float_t>(random.Uniform(-1.5, 1.5));
+      phi = static_cast<Float_t>(random.Uniform(0., 2. * TMath::Pi()));
+      mult = random.Poisson(30.);
+      weight = random.Uniform(0.5, 1.5);
+      tree.Fill();
+    }
+    tree.Write();
+  }
+  {
+    std::ofstream table(workDir + "/table.csv");
+    table << "x,y,z\n";
+    for (int64_t i = 0; i < scale.nTableRows; ++i) {
+      table << fmt::format("{:.5g},{:.5g},{:.5g}\n", random.Gaus(), random.Gaus(1., 2.), random.Uniform(0., 10.));
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Writes the plot definitions and data sources of the stress project.
+ */
+//**************************************************************************************************
+void DefineProject(const string& workDir, const scale_t& scale)
+{
+  PlotManager pm;
+  pm.AddDataSource("keys", workDir + "/keys.root");
+  pm.AddDataSource("large", workDir + "/large.root");
+  pm.AddDataSource("tree", workDir + "/tree.root");
+  pm.AddDataSource("table", workDir + "/table.csv");
+
+  pm.AddBasePlot(PlotManager::MakeBasePlot("1d"));
+  pm.AddBasePlot(PlotManager::MakeBasePlot("1d_ratio"));
+  pm.AddBasePlot(PlotManager::MakeBasePlot("2d"));
+
+  for (int32_t i = 0; i < scale.nPlots; ++i) {
+    Plot plot(fmt::format("plot{}", i), "keys", "1d");
+    for (int32_t j = 0; j < 3; ++j) {
+      plot[1].AddData(scale.KeyName(3 * i + j), "keys", fmt::format("data {}", j));
+    }
+    plot[1].AddLegend();
+    pm.AddPlot(plot);
+  }
+  for (int32_t i = 0; i < scale.nPlots / 4; ++i) {
+    Plot plot(fmt::format("ratio{}", i), "ratios", "1d_ratio");
+    string numerator = scale.KeyName(2 * i);
+    string denominator = scale.KeyName(2 * i + 1);
+    plot[1].AddData(numerator, "keys", "numerator");
+    plot[1].AddData(denominator, "keys", "denominator");
+    plot[1].AddLegend();
+    plot[2].AddRatio(numerator, "keys", denominator, "keys");
+    pm.AddPlot(plot);
+  }
+  for (int32_t i = 0; i < scale.nPlots / 20; ++i) {
+    Plot plot(fmt::format("legend{}", i), "legends", "1d");
+    for (int32_t j = 0; j < scale.nLegendEntries; ++j) {
+      plot[1].AddData(scale.KeyName(scale.nLegendEntries * i + j), "keys", fmt::format("entry {} for #it{{p}}_{{T}} > {} GeV/#it{{c}}", j, i));
+    }
+    plot[1].AddLegend();
+    plot[1].AddText("synthetic stress project // many legend entries");
+    pm.AddPlot(plot);
+  }
+
+  // all projections of the tree are filled in one event loop
+  const vector<string> filters = {"mult > 20", "mult > 40", "abs(eta) < 0.8", "pt > 1"};
+  for (int32_t i = 0; i < 5 * static_cast<int32_t>(filters.size()); ++i) {
+    const string& filter = filters[i % filters.size()];
+    if (i % 5 == 0) {
+      Plot plot(fmt::format("tree{}", i), "trees", "2d");
+      plot[1].AddData("events", "tree").Project2D({"eta", 100, {-1.5, 1.5}}, {"phi", 100, {0., 6.3}}).Filter(filter).SetOptions(colz);
+      pm.AddPlot(plot);
+      continue;
+    }
+    Plot plot(fmt::format("tree{}", i), "trees", "1d");
+    if (i % 5 == 1) {
+      plot[1].AddData("events", "tree").Profile1D({"mult", 100, {0., 100.}}, "pt").Filter(filter);
+    } else {
+      plot[1].AddData("events", "tree").Project1D({"pt", 100, {0., 10.}}, (i % 5 == 2) ? std::optional<string>{"weight"} : std::nullopt).Filter(filter);
+    }
+    pm.AddPlot(plot);
+  }
+
+  {
+    Plot plot("hist2d", "large", "2d");
+    plot[1].AddData("hist2d", "large").SetOptions(colz);
+    pm.AddPlot(plot);
+  }
+  {
+    Plot plot("slices", "large", "1d");
+    for (int32_t i = 0; i < 10; ++i) {
+      plot[1].AddData("hist2d", "large", fmt::format("slice {}", i)).ProjectX(200 * i + 1, 200 * (i + 1));
+    }
+    plot[1].AddLegend();
+    pm.AddPlot(plot);
+  }
+  {
+    Plot plot("hist3d", "large", "2d");
+    plot[1].AddData("hist3d", "large").Project({0, 1}).SetOptions(colz);
+    pm.AddPlot(plot);
+  }
+  {
+    Plot plot("histSparse", "large", "2d");
+    plot[1].AddData("histSparse", "large").Project({0, 1}, {{2, 40, 60}}).SetOptions(colz);
+    pm.AddPlot(plot);
+  }
+
+  {
+    Plot plot("table1d", "tables", "1d");
+    plot[1].AddData("table", "table").Project1D({"x", 100, {-5., 5.}});
+    plot[1].AddData("table", "table").Project1D({"y", 100, {-5., 5.}}).Filter("z > 5");
+    pm.AddPlot(plot);
+  }
+  {
+    Plot plot("table2d", "tables", "2d");
+    plot[1].AddData("table", "table").Project2D({"x", 100, {-5., 5.}}, {"y", 100, {-5., 7.}}).SetOptions(colz);
+    pm.AddPlot(plot);
+  }
+
+  pm.SavePlots(".+", ".+", workDir + "/plots.info");
+  pm.SaveDataSources(workDir + "/dataSources.info");
+}
+
+namespace SciRooPlot
+{
+//**************************************************************************************************
+/**
+ * Average time of one kernel call. The setup (e.g. copying the inputs the kernel modifies) is not timed.
+ * Calls are repeated until 0.1 s are accumulated or the maximum number of iterations is reached.
+ */
+//**************************************************************************************************
+template <typename Setup, typename Kernel>
+double_t PainterBenchmark::TimeKernel(Setup setup, Kernel kernel, int32_t maxIterations)
+{
+  std::chrono::steady_clock::duration total{};
+  int32_t nIterations{};
+  while (nIterations < maxIterations && (nIterations < 3 || total < std::chrono::milliseconds(100))) {
+    auto inputs = setup();
+    auto start = std::chrono::steady_clock::now();
+    kernel(inputs);
+    total += std::chrono::steady_clock::now() - start;
+    ++nIterations;
+  }
+  return std::chrono::duration<double_t>(total).count() / nIterations;
+}
+
+//**************************************************************************************************
+/**
+ * Times Divide (all overloads), SetGraphRange, ScaleGraph, GetProjection and GenerateGradientColors.
+ */
+//**************************************************************************************************
+vector<std::pair<string, double_t>> PainterBenchmark::Run()
+{
+  TH1::AddDirectory(false);
+  vector<std::pair<string, double_t>> timings;
+
+  auto makeHist = [](int32_t nBins) {
+    auto hist = std::make_unique<TH1D>("hist", "", nBins, 0., 1.);
+    for (int32_t bin = 1; bin <= nBins; ++bin) {
+      hist->SetBinContent(bin, 1. + bin % 7);
+      hist->SetBinError(bin, std::sqrt(1. + bin % 7));
+    }
+    return hist;
+  };
+  // the shift moves the points away from the bin centers to force the interpolation
+  auto makeGraph = [](int32_t nPoints, double_t shift = 0.) {
+    auto graph = std::make_unique<TGraphErrors>(nPoints);
+    for (int32_t i = 0; i < nPoints; ++i) {
+      graph->SetPoint(i, (i + 0.5 + shift) / nPoints, 1. + i % 7);
+      graph->SetPointError(i, 0.5 / nPoints, 0.1);
+    }
+    return graph;
+  };
+  TF1 func("func", "1 + 0.1 * x", 0., 1.);
+  TRandom3 random(42);
+
+  for (int32_t size : {100, 10000, 1000000}) {
+    auto add = [&](const string& kernel, double_t time) { timings.push_back({fmt::format("kernel/{}/{}", kernel, size), time}); };
+
+    auto hist = makeHist(size);
+    auto denomHist = makeHist(size);
+    auto fineDenomHist = makeHist(2 * size);
+    auto graph = makeGraph(size);
+    auto denomGraph = makeGraph(size);
+    auto shiftedDenomGraph = makeGraph(size, 0.25);
+    auto copyHist = [&]() { return std::make_unique<TH1D>(*hist); };
+    auto copyGraph = [&]() { return std::make_unique<TGraphErrors>(*graph); };
+
+    add("Divide_TH1_TH1", TimeKernel(copyHist, [&](auto& num) { mPainter.Divide(num.get(), denomHist.get()); }));
+    add("Divide_TH1_TH1_rebinned", TimeKernel(copyHist, [&](auto& num) { mPainter.Divide(num.get(), fineDenomHist.get()); }));
+    add("Divide_TGraph_TGraph", TimeKernel(copyGraph, [&](auto& num) { mPainter.Divide(num.get(), denomGraph.get()); }));
+    add("Divide_TGraph_TGraph_interpolated", TimeKernel(copyGraph, [&](auto& num) { mPainter.Divide(num.get(), shiftedDenomGraph.get()); }));
+    add("Divide_TH1_TGraph", TimeKernel(copyHist, [&](auto& num) { mPainter.Divide(num.get(), denomGraph.get()); }));
+    add("Divide_TGraph_TH1", TimeKernel(copyGraph, [&](auto& num) { mPainter.Divide(num.get(), denomHist.get()); }));
+    add("Divide_TH1_TF1", TimeKernel(copyHist, [&](auto& num) { mPainter.Divide(num.get(), &func); }));
+    add("Divide_TGraph_TF1", TimeKernel(copyGraph, [&](auto& num) { mPainter.Divide(num.get(), &func); }));
+    add("ScaleGraph", TimeKernel(copyGraph, [&](auto& num) { mPainter.ScaleGraph(num.get(), 2.); }));
+    // SetGraphRange counts the removed points in 16 bit
+    if (size < 32768) {
+      add("SetGraphRange", TimeKernel(copyGraph, [&](auto& num) { mPainter.SetGraphRange(num.get(), 0.1, 0.9); }));
+    }
+
+    // projections of histograms with (approximately) the same total number of bins
+    auto deleteProjection = [](std::optional<data_ptr_t>& projection) {
+      if (projection) std::visit([](auto* data) { delete data; }, *projection);
+    };
+    int32_t nBins2D = static_cast<int32_t>(std::sqrt(size));
+    TH2D hist2d("hist2d", "", nBins2D, 0., 1., nBins2D, 0., 1.);
+    int32_t nBins3D = static_cast<int32_t>(std::cbrt(size));
+    TH3D hist3d("hist3d", "", nBins3D, 0., 1., nBins3D, 0., 1., nBins3D, 0., 1.);
+    for (int32_t i = 0; i < size; ++i) {
+      hist2d.Fill(random.Uniform(), random.Uniform());
+      hist3d.Fill(random.Uniform(), random.Uniform(), random.Uniform());
+    }
+    add("GetProjection_TH2_1D", TimeKernel([]() { return 0; }, [&](auto&) {
+          auto projection = mPainter.GetProjection(&hist2d, {{0}, {{1, 0.25, 0.75}}, true, std::nullopt});
+          deleteProjection(projection);
+        }));
+    add("GetProjection_TH3_2D", TimeKernel([]() { return 0; }, [&](auto&) {
+          auto projection = mPainter.GetProjection(&hist3d, {{0, 1}, {{2, 0.25, 0.75}}, true, std::nullopt});
+          deleteProjection(projection);
+        }));
+  }
+
+  // every call allocates new global colors and the number of color indices is limited, so only few calls are timed
+  const vector<std::tuple<float_t, float_t, float_t, float_t>> rgbEndpoints{{0.f, 0.f, 1.f, 0.f}, {1.f, 1.f, 0.f, 0.5f}, {1.f, 0.f, 0.f, 1.f}};
+  timings.push_back({"kernel/GenerateGradientColors/255", TimeKernel([]() { return 0; }, [&](auto&) { mPainter.GenerateGradientColors(255, rgbEndpoints); }, 20)});
+  return timings;
+}
+}  // end namespace SciRooPlot
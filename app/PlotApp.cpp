@@ -43,11 +43,16 @@ int main(int argc, char* argv[])
   string group;
   string name;
   string mode;
+  bool incremental = false;
+  bool watch = false;
+  bool profile = false;
+  string traceFile;
+  string loadReportSortBy;
 
   // handle user inputs
   try {
     po::options_description arguments("positional arguments");
-    arguments.add_options()("group", po::value<string>(), "group")("name", po::value<string>(), "name")("mode", po::value<string>(), "mode");
+    arguments.add_options()("group", po::value<string>(), "group")("name", po::value<string>(), "name")("mode", po::value<string>(), "mode")("incremental,i", "only re-generate plots whose definition or input files changed")("watch,w", "keep re-generating plots when their definition or input files change")("profile,p", "report time and memory spent in the individual stages")("trace", po::value<string>(), "write the profile as trace-event json file (e.g. for https://ui.perfetto.dev)")("load-report", po::value<string>()->implicit_value("time"), "report bytes read, keys scanned and objects deserialized per data source (sorted by time, bytes, keys, objects, deep or name)");
     po::positional_options_description pos;
     pos.add("group", 1);
     pos.add("name", 1);
@@ -66,6 +71,15 @@ int main(int argc, char* argv[])
     if (vm.count("mode")) {
       mode = vm["mode"].as<string>();
     }
+    incremental = vm.count("incremental");
+    watch = vm.count("watch");
+    if (vm.count("trace")) {
+      traceFile = vm["trace"].as<string>();
+    }
+    profile = vm.count("profile") || !traceFile.empty();
+    if (vm.count("load-report")) {
+      loadReportSortBy = vm["load-report"].as<string>();
+    }
   } catch (std::exception& e) {
     ERROR(R"(Exception "{}"! Exiting.)", e.what());
     return 1;
@@ -81,15 +95,28 @@ int main(int argc, char* argv[])
     return 1;
   }
 
+  group += "(/.*)?";  // search also in subgroups
+
+  // delegate to the resident plot server of the project if one is running (see srp serve)
+  if (!watch && !profile && loadReportSortBy.empty() && mode != "list" && mode != "show") {
+    if (auto exitCode = PlotManager::ForwardToServer(Config::Get().CurrentProject(), mode, name, group, incremental)) return *exitCode;
+  }
+
   // create plotting environment
   PlotManager pm(Config::Get().CurrentProject());
-  group += "(/.*)?";  // search also in subgroups
+  pm.SetProfiling(profile, traceFile);
+  if (!loadReportSortBy.empty()) pm.SetLoadReport(true, loadReportSortBy);
   pm.LoadPlots(name, group);
   if (mode == "list") {
     pm.ListPlots();
   } else {
-    pm.LoadDataSources();
-    pm.GeneratePlots(mode);
+    if (mode != "print") pm.LoadDataSources();
+    pm.SetIncrementalBuild(incremental);
+    if (watch) {
+      pm.WatchPlots(mode, name, group);
+    } else {
+      return pm.GeneratePlots(mode) ? 0 : 1;
+    }
   }
   return 0;
 }
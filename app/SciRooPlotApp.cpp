@@ -16,6 +16,7 @@
  ******************************************************************************************
  */
 
+#include "SciRooPlot/DataIndex.h"
 #include "SciRooPlot/Helpers.h"
 #include "SciRooPlot/Logging.h"
 #include "SciRooPlot/Plot.h"
@@ -24,11 +25,8 @@
 #include <TApplication.h>
 #include <TBrowser.h>
 #include <TFile.h>
-#include <TFolder.h>
-#include <TKey.h>
 #include <TROOT.h>
 #include <TRootBrowser.h>
-#include <TTree.h>
 
 #include <boost/program_options.hpp>
 #include <boost/property_tree/info_parser.hpp>
@@ -46,7 +44,7 @@ using std::vector;
 
 using namespace SciRooPlot;
 namespace po = boost::program_options;
-void PrintRootFileContents(const string& inputPath);
+void PrintRootFileContents(const string& inputPath, bool onlyPaths = false);
 
 int main(int argc, char* argv[])
 {
@@ -134,6 +132,7 @@ int main(int argc, char* argv[])
     PRINT("  srp confdir [<project> | @current]");
     PRINT("  srp cd      (<project> | @current)");
     PRINT("  srp edit    (<project> | @current)");
+    PRINT("  srp serve   (<project> | @current)");
     PRINT("-----------------------------------------------------------");
     PRINT("Settings:");
     PRINT("  srp color     (bright | dark | off)");
@@ -150,7 +149,7 @@ int main(int argc, char* argv[])
     PRINT("-----------------------------------------------------------");
     PRINT("Utilities:");
     PRINT("  srp open  <file>");
-    PRINT("  srp print <file>");
+    PRINT("  srp print <file>[:<path>] [paths]");
     PRINT("===========================================================");
   } else if (command == "open") {
     string fileName = project;
@@ -165,7 +164,7 @@ int main(int argc, char* argv[])
     app.Run();
   } else if (command == "print") {
     string fileName = project;
-    PrintRootFileContents(fileName);
+    PrintRootFileContents(fileName, property == "paths");
   } else if (command == "color") {
     string colorSetting = project;
     if (colorSetting == "off") {
@@ -282,6 +281,17 @@ int main(int argc, char* argv[])
       Config::GetMutable().Select(project);
       INFO("Selecting project {}.", project);
     }
+  } else if (command == "serve") {
+    if (project.empty()) {
+      ERROR("Specify project or use @current.");
+      return 1;
+    }
+    if (!Config::Get().Exists(project)) {
+      ERROR("Project {} does not exist.", project);
+      return 1;
+    }
+    PlotManager pm(project);
+    pm.ServePlots();
   } else if (command == "get") {
     if (project.empty()) {
       ERROR("Specify project or use @current.");
@@ -311,7 +321,7 @@ int main(int argc, char* argv[])
   return 0;
 }
 
-void PrintRootFileContents(const string& inputPath)
+void PrintRootFileContents(const string& inputPath, bool onlyPaths)
 {
   string fileName = inputPath;
   string startPath;
@@ -319,86 +329,39 @@ void PrintRootFileContents(const string& inputPath)
     fileName = inputPath.substr(0, pos);
     startPath = inputPath.substr(pos + 1);
   }
-  TFile inputFile(fileName.data(), "READ");
-  if (inputFile.IsZombie()) {
+  while (!startPath.empty() && startPath.back() == '/') startPath.pop_back();
+  if (!std::filesystem::exists(fileName)) {
     ERROR("Could not find file {}.", fileName);
     return;
   }
 
-  auto findObject = [](TObject* root, const string& path) -> TObject* {
-    TObject* current = root;
-    size_t pos = 0;
-    while (current && pos < path.size()) {
-      auto next = path.find('/', pos);
-      auto part = path.substr(pos, next == string::npos ? string::npos : next - pos);
+  // file contents are taken from the data index of the current project, which is only updated if the file changed
+  const string& currentProject = Config::Get().CurrentProject();
+  DataIndex dataIndex(currentProject.empty() ? (Config::Get().Path() / "dataIndex.info").string() : Config::Get().DataIndexFile(currentProject));
+  const auto& entries = dataIndex.GetEntries(std::filesystem::absolute(fileName).string());
+  dataIndex.Save();
 
-      if (current->InheritsFrom(TDirectory::Class())) {
-        current = static_cast<TDirectory*>(current)->Get(part.data());
-      } else if (current->InheritsFrom(TFolder::Class())) {
-        current = static_cast<TFolder*>(current)->GetListOfFolders()->FindObject(part.data());
-      } else if (current->InheritsFrom(TCollection::Class())) {
-        current = static_cast<TCollection*>(current)->FindObject(part.data());
-      } else {
-        return nullptr;
-      }
-      pos = next == string::npos ? path.size() : next + 1;
+  bool foundPath = startPath.empty();
+  string currentFolder;
+  for (const auto& entry : entries) {
+    if (!startPath.empty() && entry.path != startPath && entry.path.compare(0, startPath.size() + 1, startPath + "/") != 0) continue;
+    foundPath = true;
+    if (onlyPaths) {
+      PRINT("{}", entry.path);
+      continue;
     }
-    return current;
-  };
-
-  TObject* root = &inputFile;
-  if (!startPath.empty()) {
-    root = findObject(root, startPath);
-    if (!root) {
-      PRINT("Path not found: {}", startPath);
-      return;
+    if (DataIndex::IsFolder(entry.className)) continue;
+    auto pos = entry.path.rfind('/');
+    string folder = (pos == string::npos) ? "" : entry.path.substr(0, pos);
+    if (folder != currentFolder) {
+      if (!folder.empty()) PRINT("{}/", folder);
+      currentFolder = folder;
+    }
+    string name = (pos == string::npos) ? entry.path : entry.path.substr(pos + 1);
+    PRINT("- [{}] {}{}", entry.className, name, (entry.bytes > 0) ? fmt::format(" ({:.1f} kB)", entry.bytes / 1024.) : "");
+    for (const auto& [branchName, branchType] : entry.branches) {
+      PRINT("  -> {}{}", branchName, branchType.empty() ? "" : " [" + branchType + "]");
     }
   }
-
-  std::function<void(TObject*, const string&)> loopData =
-    [&](TObject* object, const string& path) {
-      TCollection* itemList = nullptr;
-      if (object->InheritsFrom(TDirectory::Class())) {
-        itemList = static_cast<TDirectory*>(object)->GetListOfKeys();
-      } else if (object->InheritsFrom(TFolder::Class())) {
-        itemList = static_cast<TFolder*>(object)->GetListOfFolders();
-      } else if (object->InheritsFrom(TCollection::Class())) {
-        itemList = static_cast<TCollection*>(object);
-      }
-      if (!itemList) {
-        string folder = path.substr(0, path.rfind('/'));
-        if (!folder.empty()) PRINT("{}/", folder);
-        PRINT("- [{}] {}", object->ClassName(), object->GetName());
-        return;
-      }
-      bool printedPath = false;
-      TIter next(itemList);
-      TObject* obj = nullptr;
-      while ((obj = next())) {
-        string name = obj->GetName();
-        if (obj->IsA() == TKey::Class()) {
-          auto* key = static_cast<TKey*>(obj);
-          name = key->GetName();
-          obj = key->ReadObj();
-        }
-        if (obj->InheritsFrom(TDirectory::Class()) || obj->InheritsFrom(TFolder::Class()) || obj->InheritsFrom(TCollection::Class())) {
-          loopData(obj, path.empty() ? name : path + "/" + name);
-        } else {
-          if (!printedPath) {
-            if (!path.empty()) PRINT("{}/", path);
-            printedPath = true;
-          }
-          PRINT("- [{}] {}", obj->ClassName(), obj->GetName());
-        }
-        if (auto* tree = dynamic_cast<TTree*>(obj)) {
-          TObjArray* branches = tree->GetListOfBranches();
-          TIter bnext(branches);
-          TBranch* br = nullptr;
-          while ((br = static_cast<TBranch*>(bnext()))) {
-            PRINT("  -> {}", br->GetName());
-          }
-        }
-      }
-    };
-  loopData(root, startPath);
+  if (!foundPath) PRINT("Path not found: {}", startPath);
 }
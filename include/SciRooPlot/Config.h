@@ -70,6 +70,8 @@ class Config
   std::filesystem::path ProjectPath(const std::string& projectName) const;
   std::string PlotsFile(const std::string& projectName) const;
   std::string DataSourcesFile(const std::string& projectName) const;
+  std::string DataIndexFile(const std::string& projectName) const;
+  std::string ServerSocketFile(const std::string& projectName) const;
   const std::string& CurrentProject() const { return mCurrentProject; }
 
   void SetVerbosity(int logLevel) { mLogLevel = logLevel; }
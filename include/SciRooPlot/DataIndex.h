@@ -0,0 +1,71 @@
+/*
+ ******************************************************************************************
+ * --------------------------------------- SciRooPlot -------------------------------------
+ * Copyright (c) 2019-2026 Mario Krüger
+ * Contact: mario.kruger@cern.ch
+ * For a full list of contributors please see doc/CONTRIBUTORS.md.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation in version 3 (or later) of the License.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * The GNU General Public License can be found here: <https://www.gnu.org/licenses/>.
+ ******************************************************************************************
+ */
+
+#ifndef INCLUDE_SCIROOPLOT_DATAINDEX_H_
+#define INCLUDE_SCIROOPLOT_DATAINDEX_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SciRooPlot
+{
+//**************************************************************************************************
+/**
+ * Persistent index of the contents of root files (path, class, size and branches of all objects).
+ * The index is stored in an info file and the entries of a file are only rebuilt once its size or modification time changed.
+ */
+//**************************************************************************************************
+class DataIndex
+{
+ public:
+  struct entry_t {
+    std::string path;
+    std::string className;
+    int64_t bytes{};  // size of the object in the file (zero for objects stored inside collections)
+    std::vector<std::pair<std::string, std::string>> branches;  // name, type
+  };
+
+  explicit DataIndex(std::filesystem::path indexFile);
+
+  const std::vector<entry_t>& GetEntries(const std::string& fileName);
+  void Prune();
+  void Save() const;
+
+  static bool IsFolder(const std::string& className);
+
+ private:
+  struct file_entry_t {
+    int64_t size{};
+    int64_t writeTime{};
+    std::vector<entry_t> entries;
+  };
+
+  void Load();
+  static std::vector<entry_t> IndexFile(const std::string& fileName);
+
+  std::filesystem::path mIndexFile;
+  std::map<std::string, file_entry_t> mFiles;
+  bool mIsModified{false};
+};
+
+}  // end namespace SciRooPlot
+#endif  // INCLUDE_SCIROOPLOT_DATAINDEX_H_
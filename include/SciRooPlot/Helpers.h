@@ -35,6 +35,7 @@ namespace SciRooPlot
 std::string expand_path(const std::string& path);
 std::vector<std::string> split_string(const std::string& argString, char delimiter, bool onlyFirst = false);
 bool file_exists(const std::string& name);
+uint64_t hash_string(const std::string& str);
 
 inline bool str_contains(const std::string& str, const std::string& substr, bool reverseSearch = false)
 {
@@ -494,6 +494,7 @@ class Plot::Pad::Data
   virtual Data& RebinY(uint16_t nGroup);
   virtual Data& RebinXY(uint16_t nGroupX, uint16_t nGroupY);
   virtual Data& Smooth(uint16_t nIterSmooth = 1);
+  virtual Data& Decimate(bool decimate = true);  // for graphs: skip points that overlap at the output resolution
 
   virtual Data& Project(std::vector<uint8_t> dims, std::vector<std::tuple<uint8_t, double_t, double_t>> ranges = {}, std::optional<bool> isUserCoord = {});
   virtual Data& ProjectX(double_t startY = 0, double_t endY = -1, std::optional<bool> isUserCoord = {});  // for 2d histos
@@ -503,13 +504,21 @@ class Plot::Pad::Data
   virtual Data& ProfileX(double_t startY = 0, double_t endY = -1, std::optional<bool> isUserCoord = {});                                                     // for 2d histos
   virtual Data& ProfileY(double_t startX = 0, double_t endX = -1, std::optional<bool> isUserCoord = {});                                                     // for 2d histos
 
+  // binning derived from the data in case no range is specified
+  enum binning_t : uint8_t { uniform,
+                             quantile,           // bins with equal number of entries
+                             freedman_diaconis,  // bin width 2 * IQR / cbrt(N), the number of bins is ignored
+                             logarithmic };
   struct data_dim_t {
     data_dim_t(const char* _var, int32_t _nBins = 100, const std::vector<double_t>& _range = {0, 0}) : var(_var), edges(_range), nBins(_nBins) {}
     data_dim_t(const std::string& _var, int32_t _nBins = 100, const std::vector<double_t>& _range = {0, 0}) : var(_var), edges(_range), nBins(_nBins) {}
     data_dim_t(const std::string& _var, const std::vector<double_t>& _edges) : var(_var), edges(_edges) {}
+    data_dim_t(const char* _var, binning_t _binning, int32_t _nBins = 100) : var(_var), edges({0, 0}), nBins(_nBins), binning(_binning) {}
+    data_dim_t(const std::string& _var, binning_t _binning, int32_t _nBins = 100) : var(_var), edges({0, 0}), nBins(_nBins), binning(_binning) {}
     std::string var{};
     std::vector<double_t> edges{};
     int32_t nBins{0};
+    binning_t binning{uniform};
   };
 
   virtual Data& Project(const std::vector<data_dim_t>& dataDims, std::optional<std::string> weight = {});
@@ -528,6 +537,7 @@ class Plot::Pad::Data
   virtual Data& Filter(const std::string& filter);
   virtual Data& Entries(uint32_t nEntries);
   virtual Data& Entries(uint32_t entryMin, uint32_t entryMax);
+  virtual Data& Sparse(bool sparse = true);
 
  protected:
   friend class PlotManager;
@@ -572,6 +582,7 @@ class Plot::Pad::Data
   const auto& GetDataInfo() const { return mDataInfo; }
   const auto& GetProjInfo() const { return mProjInfo; }
   const auto& GetNiterSmooth() const { return mNiterSmooth; }
+  const auto& GetDecimate() const { return mDecimate; }
   const auto& GetRebinGroupX() const { return mModify.rebinGroupX; }
   const auto& GetRebinGroupY() const { return mModify.rebinGroupY; }
   const auto& GetDivideBinWidth() const { return mModify.divideBinWidth; }
@@ -600,17 +611,13 @@ class Plot::Pad::Data
       std::optional<uint32_t> max{};
     };
     entry_range_t entries;
+    std::optional<bool> isSparse{};  // for more than three dimensions (by default chosen depending on number of bins)
     void set(const data_info_t& other)
     {
       dataDims = other.dataDims;
       weight = other.weight;
       isProfileNoScatter = other.isProfileNoScatter;
     }
-    bool singleProc()
-    {
-      // disable multi processing in case scatter (order might be relevant) or range is requested
-      return !isProfileNoScatter.value_or(true) || entries.max.value_or(false);
-    }
     std::string GetNameSuffix() const;
   };
 
@@ -660,6 +667,7 @@ class Plot::Pad::Data
   std::optional<std::vector<double_t>> mContours;
   std::optional<int32_t> mNContours;
   std::optional<uint16_t> mNiterSmooth;
+  std::optional<bool> mDecimate;
 };
 
 //**************************************************************************************************
@@ -738,6 +746,7 @@ class Plot::Pad::Ratio : public Plot::Pad::Data
   FORWARD_TO_DATA(RebinY)
   FORWARD_TO_DATA(RebinXY)
   FORWARD_TO_DATA(Smooth)
+  FORWARD_TO_DATA(Decimate)
 
   Ratio& Numer();  // switch to numerator for following modifiers (default)
   Ratio& Denom();  // switch to denominator for following modifiers
@@ -766,6 +775,7 @@ class Plot::Pad::Ratio : public Plot::Pad::Data
   Ratio& Filter(const std::string& filter);
   Ratio& Entries(uint32_t nEntries);
   Ratio& Entries(uint32_t entryMin, uint32_t entryMax);
+  Ratio& Sparse(bool sparse = true);
 
  protected:
   friend class PlotManager;
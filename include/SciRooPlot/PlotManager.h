@@ -21,16 +21,22 @@
 
 #include "SciRooPlot/Plot.h"
 
+#include <ROOT/RVec.hxx>
 #include <TApplication.h>
 
+#include <functional>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
 class TCanvas;
+struct sockaddr_un;
 namespace ROOT
 {
 class RDataFrame;
@@ -38,6 +44,8 @@ class RDataFrame;
 
 namespace SciRooPlot
 {
+class DataIndex;
+
 //**************************************************************************************************
 /**
  * Central manager class.
@@ -48,7 +56,7 @@ class PlotManager
  public:
   explicit PlotManager(const std::string& projectName = "");
 
-  ~PlotManager() = default;
+  ~PlotManager();
   PlotManager(const PlotManager& other) = delete;
   PlotManager(PlotManager&&) = delete;
   PlotManager& operator=(const PlotManager& other) = delete;
@@ -65,6 +73,14 @@ class PlotManager
   void AddDataSource(const std::string& dataSource, const std::vector<TObject*>& inputData);
   void AddDataSource(const std::string& dataSource, TObject* inputData);
 
+  // column of an in-memory table, the values can be a non-owning view of memory that is kept alive by the owner
+  struct column_t {
+    std::variant<ROOT::RVec<Double_t>, ROOT::RVec<Float_t>, ROOT::RVec<Long64_t>, ROOT::RVec<Int_t>, ROOT::RVec<Bool_t>> values;
+    std::shared_ptr<void> owner;
+  };
+  using table_t = std::map<std::string, column_t>;  // column name -> column
+  void AddDataSource(const std::string& dataSource, const std::string& tableName, table_t columns);
+
   void SaveDataSources(const std::optional<std::string>& file = {}) const;
   void LoadDataSources(const std::optional<std::string>& file = {});
 
@@ -74,25 +90,55 @@ class PlotManager
 
   void SavePlots(const std::string& name = ".+", const std::string& group = ".+", const std::optional<std::string>& file = {}) const;
   void LoadPlots(const std::string& name = ".+", const std::string& group = ".+", const std::optional<std::string>& file = {});
-  void GeneratePlots(const std::string& mode = "show", const std::string& name = ".+", const std::string& group = ".+");
+  bool GeneratePlots(const std::string& mode = "show", const std::string& name = ".+", const std::string& group = ".+");
+  void WatchPlots(const std::string& mode = "show", const std::string& name = ".+", const std::string& group = ".+");
+  void ServePlots();
+  static std::optional<int32_t> ForwardToServer(const std::string& projectName, const std::string& mode, const std::string& name = ".+", const std::string& group = ".+", bool incremental = false);
   void ListPlots() const;
+  std::string RenderToBuffer(const std::string& name, const std::string& group, const std::string& format = "png");
 
   std::string GetProjectProperty(const std::string& property) const;
 
   void SetOutputDirectory(const std::string& path);
+  void SetDecimateVectorMarkers(bool decimate = true);
+  void SetIncrementalBuild(bool incremental = true);
+  void SetProfiling(bool profile = true, const std::string& traceFile = "");
+  void SetLoadReport(bool report = true, const std::string& sortBy = "time");
 
  private:
+  static bool GetServerAddress(const std::string& projectName, sockaddr_un& address);
+  void InitApplication();
   TObject* FindSubDirectory(TObject* folder, std::vector<std::string>& subDirs) const;
+  bool GenerateSelectedPlots(const std::vector<Plot*>& selectedPlots, const std::string& mode);
   bool GeneratePlot(const Plot& plot, const std::string& mode = "pdf");
+  std::optional<std::string> PrintToBuffer(TCanvas* canvas, const std::string& format) const;
+  Plot GetFullPlot(const Plot& plot) const;
+  std::string GetOutputFilePath(const Plot& plot, const std::string& fileEnding) const;
+  std::string GetFileFingerprint(const std::string& fileName) const;
+  const std::map<std::string, std::string>& GetKeyFingerprints(const std::string& inputFileName) const;
+  std::set<std::string> GetIndexedData(DataIndex& dataIndex, const std::string& dataSource) const;
+  std::map<std::string, std::set<std::string>> GetRequiredData(Plot& fullPlot) const;
+  std::string GetBuildHash(Plot& fullPlot) const;
+  bool IsUpToDate(Plot& fullPlot, const std::string& outputFile) const;
+  void WriteManifest(const std::string& outputFile, const std::string& buildHash) const;
   void SavePlotsToRootFile() const;
-  void SaveDataToRootFile() const;
+  void SaveDataToRootFile(const std::map<std::string, std::set<std::string>>& selectedData) const;
 
   std::unique_ptr<TApplication> mApp;
   std::string mProjectName;
   const std::string mPlotsRootFile{"Plots.root"};
   const std::string mDataRootFile{"Data.root"};
+  const double_t mMaxDenseBins{1e7};  // above this number of bins histograms with more than three dimensions are stored as sparse
   std::map<std::string, std::shared_ptr<TCanvas>> mCanvasRegistry;
+  std::map<std::pair<int32_t, int32_t>, std::unique_ptr<TCanvas>> mCanvasPool;  // off-screen canvases for re-use in batch mode (by width and height)
+  std::string mRenderFormat{"png"};  // format used by RenderToBuffer
+  std::optional<std::string> mRenderedBuffer;  // content of the plot printed by RenderToBuffer
   std::string mOutputDirectory;
+  bool mDecimateVectorMarkers{false};
+  bool mIncrementalBuild{false};
+  bool mLoadReport{false};
+  std::string mLoadReportSortBy{"time"};
+  bool mIsWatching{false};
   std::vector<Plot> mPlots;
   std::vector<Plot> mBasePlots;
   std::map<std::string, boost::property_tree::ptree> mPropertyTreeCache;
@@ -100,15 +146,33 @@ class PlotManager
   int32_t mWindowOffsetY{};
   int32_t mFirstFreeColorIndex{TColor::GetFreeColorIndex()};
   const std::vector<std::string> mTableFileEndings = {".csv", ".dat", ".txt", ".tsv", ".tab"};
+  const std::vector<std::string> mFileFormats = {"pdf", "png", "eps", "svg", "ps", "html", "json", "xml", "jpg", "root"};
 
   std::unordered_map<std::string, std::unordered_map<std::string, std::unique_ptr<TObject>>> mDataBuffer;
+  std::unordered_map<std::string, std::unordered_map<std::string, std::string>> mDataKeys;  // dataSource -> name in data buffer -> path of the key it was read from
   std::unordered_map<std::string, std::unordered_map<std::string, std::vector<Plot::Pad::Data::data_info_t>>> mDataInfoBuffer;
   std::map<std::string, std::vector<std::string>> mInputFiles;  // dataSource name -> input file paths
+  std::map<std::string, std::map<std::string, table_t>> mTables;  // dataSource name -> table name -> in-memory columns
+  mutable std::map<std::string, std::pair<std::string, std::map<std::string, std::string>>> mKeyFingerprintCache;  // input file -> file fingerprint, key path -> key fingerprint
+  struct load_stats_t {
+    int64_t bytesRead{};
+    uint32_t keysScanned{};
+    uint32_t objectsRead{};  // deserialized objects including traversed directories and lists
+    uint32_t requested{};
+    uint32_t found{};
+    uint32_t deepLookups{};  // data that was only found when traversing sub-directories and lists
+    double_t time{};        // in seconds
+  };
+  std::map<std::string, std::map<std::string, load_stats_t>> mLoadStats;  // dataSource -> input file -> statistics of the last FillBuffer()
   void PrintBufferStatus(bool onlyMissing = false) const;
+  void PrintLoadReport() const;
   bool FillBuffer();
-  void ReadData(TObject* folder, std::vector<std::string>& dataNames, const std::string& prefix, const std::string& suffix, const std::string& dataSource);
+  void ReadData(TObject* folder, std::vector<std::string>& dataNames, const std::string& prefix, const std::string& suffix, const std::string& dataSource, load_stats_t& stats, const std::string& keyPath, bool isNested = false);
   void ReadTableData(const std::string& inputFileName, const std::string& name, const std::string& dataSource);
-  TObject* ProcessData(ROOT::RDataFrame& df, const std::string& dfName, const Plot::Pad::Data::data_info_t& treeInfo, const std::string& name) const;
+  void ReadMemoryTable(const std::string& name, const table_t& columns, const std::string& dataSource);
+  struct DataFrameGraph;
+  std::function<TObject*()> ProcessData(DataFrameGraph& dfGraph, const std::string& dfName, const Plot::Pad::Data::data_info_t& treeInfo, const std::string& name) const;
+  void ProcessDataFrame(ROOT::RDataFrame& df, const std::string& dfName, const std::string& dataSource, const std::string& suffix, const table_t* columns = nullptr);
 };
 
 }  // end namespace SciRooPlot
@@ -21,6 +21,7 @@
 
 #include "SciRooPlot/Plot.h"
 
+#include <array>
 #include <map>
 #include <memory>
 #include <string>
@@ -133,9 +134,12 @@ inline const std::map<drawing_options_t, std::string> defaultDrawingOptions_Grap
 class PlotPainter
 {
  public:
-  std::unique_ptr<TCanvas> GeneratePlot(Plot& plot, const std::unordered_map<std::string, std::unordered_map<std::string, std::unique_ptr<TObject>>>& dataBuffer);
+  std::unique_ptr<TCanvas> GeneratePlot(Plot& plot, const std::unordered_map<std::string, std::unordered_map<std::string, std::unique_ptr<TObject>>>& dataBuffer, std::unique_ptr<TCanvas> canvas_ptr = nullptr);
+  void DecimateOverlappingMarkers(TPad* pad);
 
  private:
+  friend class PainterBenchmark;  // times the numeric kernels directly (srp_bench)
+
   std::optional<data_ptr_t> GetDataClone(TObject* obj, const std::optional<Plot::Pad::Data::proj_info_t>& projInfo = std::nullopt);
   template <typename T>
   std::optional<data_ptr_t> GetDataClone(TObject* obj);
@@ -145,6 +149,9 @@ class PlotPainter
 
   void SetGraphRange(TGraph* graph, std::optional<double_t> min, std::optional<double_t> max);
   void ScaleGraph(TGraph* graph, double_t scale);
+  void DecimateMarkers(TGraph* graph, TPad* pad);
+  void DecimateLine(TGraph* graph, TPad* pad);
+  void SelectGraphPoints(TGraph* graph, const std::vector<int32_t>& points);
 
   void Divide(TGraph* numerator, TGraph* denominator, bool binomialErrors = false);
   void Divide(TH1* numerator, TH1* denominator, bool binomialErrors = false);
@@ -152,6 +159,8 @@ class PlotPainter
   void Divide(TGraph* numerator, TH1* denominator, bool binomialErrors = false);
   void Divide(TH1* numerator, TF1* denominator, bool binomialErrors = false);
   void Divide(TGraph* numerator, TF1* denominator, bool binomialErrors = false);
+  std::optional<std::vector<int32_t>> GetAlignedBinMap(TAxis* fineAxis, TAxis* coarseAxis);
+  void FillAlignedRebin(TH1* fineHist, TH1* coarseHist, const std::array<std::vector<int32_t>, 3>& binMaps);
 
   bool CheckFontSizes(TList* list);
   std::tuple<uint32_t, uint32_t> GetTextDimensions(TLatex& text, TPad* pad);
@@ -0,0 +1,98 @@
+/*
+ ******************************************************************************************
+ * --------------------------------------- SciRooPlot -------------------------------------
+ * Copyright (c) 2019-2026 Mario Krüger
+ * Contact: mario.kruger@cern.ch
+ * For a full list of contributors please see doc/CONTRIBUTORS.md.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation in version 3 (or later) of the License.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * The GNU General Public License can be found here: <https://www.gnu.org/licenses/>.
+ ******************************************************************************************
+ */
+
+#ifndef INCLUDE_SCIROOPLOT_PROFILER_H_
+#define INCLUDE_SCIROOPLOT_PROFILER_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace SciRooPlot
+{
+//**************************************************************************************************
+/**
+ * Records time and resident memory spent in the individual stages of the plot generation.
+ * Stages are measured by Profiler::Scope objects and are only recorded while the profiler is enabled.
+ * The profiler is shared by the whole process, so only one owner (plot manager) can enable it at a time and only this owner reports and resets the recorded stages.
+ * Stages of other plot managers running at the same time are recorded as well.
+ */
+//**************************************************************************************************
+class Profiler
+{
+ public:
+  static Profiler& Get();
+
+  bool Enable(const void* owner, bool enable = true, const std::string& traceFile = "");
+  bool IsEnabled() const { return mOwner.load(std::memory_order_relaxed) != nullptr; }
+
+  void Report(const void* owner);
+
+  //************************************************************************************************
+  /**
+   * Measures the stage from construction until it goes out of scope. The item denotes what is processed (e.g. plot or data source).
+   */
+  //************************************************************************************************
+  class Scope
+  {
+   public:
+    explicit Scope(const char* stage, const std::string& item = "");
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    const char* mStage;
+    std::string mItem;
+    bool mIsActive;
+    std::chrono::steady_clock::time_point mStart;
+    int64_t mStartMemory{};
+  };
+
+ private:
+  Profiler() = default;
+
+  struct event_t {
+    std::string stage;
+    std::string item;
+    int64_t start;     // in microseconds since the profiler was reset
+    int64_t duration;  // in microseconds
+    int64_t memory;    // change of resident memory in kB
+    int64_t residentMemory;
+    uint32_t thread;
+    int32_t depth;
+  };
+
+  static int64_t GetResidentMemory();
+  void Record(event_t event);
+  void Reset();
+  void PrintSummary() const;
+  void WriteTrace() const;
+
+  std::atomic<const void*> mOwner{nullptr};
+  std::string mTraceFile;
+  std::chrono::steady_clock::time_point mOrigin{std::chrono::steady_clock::now()};
+  std::mutex mMutex;
+  std::vector<event_t> mEvents;
+};
+
+}  // end namespace SciRooPlot
+#endif  // INCLUDE_SCIROOPLOT_PROFILER_H_
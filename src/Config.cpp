@@ -276,6 +276,18 @@ std::string Config::DataSourcesFile(const string& projectName) const
   return mPath / projectName / "dataSources.info";
 }
 
+std::string Config::DataIndexFile(const string& projectName) const
+{
+  if (projectName.empty()) return projectName;
+  return mPath / projectName / "dataIndex.info";
+}
+
+std::string Config::ServerSocketFile(const string& projectName) const
+{
+  if (projectName.empty()) return projectName;
+  return mPath / projectName / "server.sock";
+}
+
 void Config::SetProgram(const string& projectName, const string& program)
 {
   if (std::filesystem::path(expand_path(program)).is_relative()) {
@@ -0,0 +1,256 @@
+/*
+ ******************************************************************************************
+ * --------------------------------------- SciRooPlot -------------------------------------
+ * Copyright (c) 2019-2026 Mario Krüger
+ * Contact: mario.kruger@cern.ch
+ * For a full list of contributors please see doc/CONTRIBUTORS.md.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation in version 3 (or later) of the License.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * The GNU General Public License can be found here: <https://www.gnu.org/licenses/>.
+ ******************************************************************************************
+ */
+
+#include "SciRooPlot/DataIndex.h"
+
+#include "SciRooPlot/Logging.h"
+#include "SciRooPlot/Profiler.h"
+
+#include <TBranch.h>
+#include <TClass.h>
+#include <TCollection.h>
+#include <TFile.h>
+#include <TFolder.h>
+#include <TKey.h>
+#include <TLeaf.h>
+#include <TTree.h>
+
+#include <boost/property_tree/info_parser.hpp>
+
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using boost::property_tree::ptree;
+using std::string;
+using std::vector;
+
+namespace SciRooPlot
+{
+//**************************************************************************************************
+/**
+ * Loads the index stored in the specified file (if it exists already).
+ */
+//**************************************************************************************************
+DataIndex::DataIndex(std::filesystem::path indexFile) : mIndexFile(std::move(indexFile))
+{
+  Load();
+}
+
+void DataIndex::Load()
+{
+  if (mIndexFile.empty() || !std::filesystem::exists(mIndexFile)) return;
+  ptree indexTree;
+  try {
+    boost::property_tree::read_info(mIndexFile.string(), indexTree);
+  } catch (...) {
+    WARNING("Cannot read data index {}. It will be rebuilt.", mIndexFile.string());
+    return;
+  }
+  for (const auto& [fileKey, fileTree] : indexTree) {
+    if (fileKey != "FILE") continue;
+    auto& file = mFiles[fileTree.get<string>("name", "")];
+    file.size = fileTree.get<int64_t>("size", -1);
+    file.writeTime = fileTree.get<int64_t>("time", -1);
+    for (const auto& [objectKey, objectTree] : fileTree) {
+      if (objectKey != "OBJECT") continue;
+      entry_t entry{objectTree.get<string>("path", ""), objectTree.get<string>("class", ""), objectTree.get<int64_t>("bytes", 0)};
+      for (const auto& [branchKey, branchTree] : objectTree) {
+        if (branchKey != "BRANCH") continue;
+        entry.branches.emplace_back(branchTree.get<string>("name", ""), branchTree.get<string>("type", ""));
+      }
+      file.entries.push_back(std::move(entry));
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Writes the index to its file in case it changed, together with a plain list of the object paths next to it (extension .paths).
+ */
+//**************************************************************************************************
+void DataIndex::Save() const
+{
+  if (mIndexFile.empty()) return;
+  auto pathsFileName = std::filesystem::path(mIndexFile).replace_extension(".paths");
+  if (!mIsModified && std::filesystem::exists(pathsFileName)) return;
+  ptree indexTree;
+  for (const auto& [fileName, file] : mFiles) {
+    ptree fileTree;
+    fileTree.put("name", fileName);
+    fileTree.put("size", file.size);
+    fileTree.put("time", file.writeTime);
+    for (const auto& entry : file.entries) {
+      ptree objectTree;
+      objectTree.put("path", entry.path);
+      objectTree.put("class", entry.className);
+      objectTree.put("bytes", entry.bytes);
+      for (const auto& [branchName, branchType] : entry.branches) {
+        ptree branchTree;
+        branchTree.put("name", branchName);
+        branchTree.put("type", branchType);
+        objectTree.add_child("BRANCH", branchTree);
+      }
+      fileTree.add_child("OBJECT", objectTree);
+    }
+    indexTree.add_child("FILE", fileTree);
+  }
+  std::filesystem::create_directories(mIndexFile.parent_path());
+  boost::property_tree::write_info(mIndexFile.string(), indexTree);
+
+  // plain text list of all object paths (file name and path separated by a tab) that the shell completion can read without starting srp
+  std::ofstream pathsFile(pathsFileName);
+  for (const auto& [fileName, file] : mFiles) {
+    for (const auto& entry : file.entries) {
+      pathsFile << fileName << '\t' << entry.path << '\n';
+    }
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Returns the contents of a root file. The file is only opened if it was not indexed yet or changed since.
+ */
+//**************************************************************************************************
+const vector<DataIndex::entry_t>& DataIndex::GetEntries(const string& fileName)
+{
+  static const vector<entry_t> noEntries;
+  std::error_code sizeError, timeError;
+  auto fileSize = std::filesystem::file_size(fileName, sizeError);
+  auto writeTime = std::filesystem::last_write_time(fileName, timeError);
+  if (sizeError || timeError) {
+    if (mFiles.erase(fileName)) mIsModified = true;
+    return noEntries;
+  }
+  int64_t size = static_cast<int64_t>(fileSize);
+  int64_t time = writeTime.time_since_epoch().count();
+  if (auto file = mFiles.find(fileName); file != mFiles.end() && file->second.size == size && file->second.writeTime == time) {
+    return file->second.entries;
+  }
+  auto& file = mFiles[fileName];
+  file = {size, time, IndexFile(fileName)};
+  mIsModified = true;
+  return file.entries;
+}
+
+//**************************************************************************************************
+/**
+ * Removes files from the index that do not exist anymore.
+ */
+//**************************************************************************************************
+void DataIndex::Prune()
+{
+  for (auto file = mFiles.begin(); file != mFiles.end();) {
+    if (std::filesystem::exists(file->first)) {
+      ++file;
+      continue;
+    }
+    file = mFiles.erase(file);
+    mIsModified = true;
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Checks if objects of this class contain further objects (directories, folders and collections).
+ */
+//**************************************************************************************************
+bool DataIndex::IsFolder(const string& className)
+{
+  TClass* objectClass = TClass::GetClass(className.data(), true, true);
+  if (!objectClass) return false;
+  return objectClass->InheritsFrom(TDirectory::Class()) || objectClass->InheritsFrom(TFolder::Class()) || objectClass->InheritsFrom(TCollection::Class());
+}
+
+//**************************************************************************************************
+/**
+ * Collects path, class and size of all objects in a root file. For plain objects only the key headers are read.
+ * Trees and collections have to be read in order to list their branches and contents, but none of the tree entries are loaded.
+ */
+//**************************************************************************************************
+vector<DataIndex::entry_t> DataIndex::IndexFile(const string& fileName)
+{
+  Profiler::Scope profileScope("IndexData", fileName);
+  LOG("Indexing contents of {}.", fileName);
+  vector<entry_t> entries;
+  TFile inputFile(fileName.data(), "READ");
+  if (inputFile.IsZombie()) return entries;
+
+  std::function<void(TObject*, const string&)> collectObjects;
+  collectObjects = [&](TObject* object, const string& path) {
+    entry_t entry{path, object->ClassName()};
+    if (auto* tree = dynamic_cast<TTree*>(object)) {
+      for (auto* obj : *tree->GetListOfBranches()) {
+        auto* branch = static_cast<TBranch*>(obj);
+        string type = branch->GetClassName();
+        if (auto* leaf = static_cast<TLeaf*>(branch->GetListOfLeaves()->First()); type.empty() && leaf) {
+          type = leaf->GetTypeName();
+        }
+        entry.branches.emplace_back(branch->GetName(), type);
+      }
+    }
+    entries.push_back(std::move(entry));
+
+    TCollection* items = nullptr;
+    if (auto* folder = dynamic_cast<TFolder*>(object)) {
+      items = folder->GetListOfFolders();
+    } else if (auto* collection = dynamic_cast<TCollection*>(object)) {
+      items = collection;
+    }
+    if (!items) return;
+    for (auto* item : *items) {
+      collectObjects(item, path + "/" + item->GetName());
+    }
+  };
+
+  std::function<void(TDirectory*, const string&)> collectKeys;
+  collectKeys = [&](TDirectory* dir, const string& prefix) {
+    std::set<string> keyNames;
+    for (auto* obj : *dir->GetListOfKeys()) {
+      auto* key = static_cast<TKey*>(obj);
+      // keys are ordered by cycle, so only the most recent one is indexed
+      if (!keyNames.insert(key->GetName()).second) continue;
+      string path = prefix + key->GetName();
+      TClass* keyClass = TClass::GetClass(key->GetClassName(), true, true);
+      bool isDirectory = keyClass && keyClass->InheritsFrom(TDirectory::Class());
+      bool hasContents = keyClass && (keyClass->InheritsFrom(TTree::Class()) || keyClass->InheritsFrom(TFolder::Class()) || keyClass->InheritsFrom(TCollection::Class()));
+      if (!hasContents) {
+        entries.push_back({path, key->GetClassName(), key->GetNbytes()});
+        if (TDirectory* subDir = isDirectory ? dir->GetDirectory(key->GetName()) : nullptr) {
+          collectKeys(subDir, path + "/");
+        }
+        continue;
+      }
+      std::unique_ptr<TObject> object(key->ReadObj());
+      if (!object) continue;
+      if (auto* collection = dynamic_cast<TCollection*>(object.get())) collection->SetOwner(true);
+      size_t objectIndex = entries.size();
+      collectObjects(object.get(), path);
+      entries[objectIndex].bytes = key->GetNbytes();
+      if (auto* tree = dynamic_cast<TTree*>(object.get())) entries[objectIndex].bytes += tree->GetZipBytes();
+    }
+  };
+  collectKeys(&inputFile, "");
+  return entries;
+}
+
+}  // end namespace SciRooPlot
@@ -63,4 +63,15 @@ bool file_exists(const string& name)
   return (stat(name.c_str(), &buffer) == 0);
 }
 
+uint64_t hash_string(const string& str)
+{
+  // FNV-1a hash, which (in contrast to std::hash) is stable across compilers and sessions
+  uint64_t hash = 14695981039346656037ull;
+  for (unsigned char character : str) {
+    hash ^= character;
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
 }  // end namespace SciRooPlot
@@ -1482,6 +1482,7 @@ Plot::Pad::Data::Data(const ptree& dataTree) : Data()
   read_from_tree(dataTree, mContours, "contours");
   read_from_tree(dataTree, mNContours, "number_of_contours");
   read_from_tree(dataTree, mNiterSmooth, "nIter_smooth");
+  read_from_tree(dataTree, mDecimate, "decimate");
 
   // extract data info
   {
@@ -1507,12 +1508,20 @@ Plot::Pad::Data::Data(const ptree& dataTree) : Data()
           dataDims.push_back({vars->at(i), nBins, edges});
         }
       }
+      optional<vector<uint8_t>> binningModes;
+      read_from_tree(dataTree, binningModes, "data_binning_modes");
+      if (binningModes && binningModes->size() == dataDims.size()) {
+        for (int i = 0; i < dataDims.size(); ++i) {
+          dataDims[i].binning = static_cast<binning_t>((*binningModes)[i]);
+        }
+      }
       mDataInfo.dataDims = dataDims;
       read_from_tree(dataTree, mDataInfo.filters, "data_filters");
       read_from_tree(dataTree, mDataInfo.weight, "data_weight");
       read_from_tree(dataTree, mDataInfo.entries.min, "data_entryMin");
       read_from_tree(dataTree, mDataInfo.entries.max, "data_entryMax");
       read_from_tree(dataTree, mDataInfo.isProfileNoScatter, "data_isProfileNoScatter");
+      read_from_tree(dataTree, mDataInfo.isSparse, "data_isSparse");
       read_from_tree(dataTree, mDataInfo.definitions.keys, "data_definitions_keys");
       read_from_tree(dataTree, mDataInfo.definitions.values, "data_definitions_values");
     }
@@ -1578,25 +1587,32 @@ ptree Plot::Pad::Data::GetPropertyTree() const
   put_in_tree(dataTree, mContours, "contours");
   put_in_tree(dataTree, mNContours, "number_of_contours");
   put_in_tree(dataTree, mNiterSmooth, "nIter_smooth");
+  put_in_tree(dataTree, mDecimate, "decimate");
 
   if (mDataInfo.dataDims.size()) {
     vector<string> vars;
     vector<double_t> binning;
     vector<int32_t> sizes;
+    vector<uint8_t> binningModes;
     for (auto dataDim : mDataInfo.dataDims) {
       vars.push_back(dataDim.var);
       binning.insert(binning.end(), dataDim.edges.begin(), dataDim.edges.end());
       binning.push_back(static_cast<double_t>(dataDim.nBins));
       sizes.push_back(static_cast<int32_t>(dataDim.edges.size()) + 1);
+      binningModes.push_back(dataDim.binning);
     }
     put_in_tree(dataTree, optional<vector<string>>{vars}, "data_vars");
     put_in_tree(dataTree, optional<vector<double_t>>{binning}, "data_binning");
     put_in_tree(dataTree, optional<vector<int32_t>>{sizes}, "data_binning_sizes");
+    if (std::any_of(binningModes.begin(), binningModes.end(), [](uint8_t mode) { return mode != uniform; })) {
+      put_in_tree(dataTree, optional<vector<uint8_t>>{binningModes}, "data_binning_modes");
+    }
     put_in_tree(dataTree, mDataInfo.filters, "data_filters");
     put_in_tree(dataTree, mDataInfo.weight, "data_weight");
     put_in_tree(dataTree, mDataInfo.entries.min, "data_entryMin");
     put_in_tree(dataTree, mDataInfo.entries.max, "data_entryMax");
     put_in_tree(dataTree, mDataInfo.isProfileNoScatter, "data_isProfileNoScatter");
+    put_in_tree(dataTree, mDataInfo.isSparse, "data_isSparse");
     put_in_tree(dataTree, mDataInfo.definitions.keys, "data_definitions_keys");
     put_in_tree(dataTree, mDataInfo.definitions.values, "data_definitions_values");
   }
@@ -1906,6 +1922,11 @@ auto Plot::Pad::Data::Smooth(uint16_t nIterSmooth) -> decltype(*this)
   mNiterSmooth = nIterSmooth;
   return *this;
 }
+auto Plot::Pad::Data::Decimate(bool decimate) -> decltype(*this)
+{
+  mDecimate = decimate;
+  return *this;
+}
 auto Plot::Pad::Data::DivideBinWidth(bool divideBinWidth) -> decltype(*this)
 {
   mModify.divideBinWidth = divideBinWidth;
@@ -2034,6 +2055,11 @@ auto Plot::Pad::Data::Entries(uint32_t entryMin, uint32_t entryMax) -> decltype(
   mDataInfo.entries.max = entryMax;
   return *this;
 }
+auto Plot::Pad::Data::Sparse(bool sparse) -> decltype(*this)
+{
+  mDataInfo.isSparse = sparse;
+  return *this;
+}
 
 //**************************************************************************************************
 /**
@@ -2081,6 +2107,7 @@ string Plot::Pad::Data::data_info_t::GetNameSuffix() const
       nameSuffix += std::to_string(edge);
     }
     nameSuffix += std::to_string(dataDim.nBins);
+    if (dataDim.binning != uniform) nameSuffix += "#" + std::to_string(dataDim.binning);
   }
   if (filters) {
     for (const auto& filter : *filters) {
@@ -2096,6 +2123,7 @@ string Plot::Pad::Data::data_info_t::GetNameSuffix() const
   if (entries.min) nameSuffix += ";" + std::to_string(*entries.min);
   if (entries.max) nameSuffix += ";" + std::to_string(*entries.max);
   if (isProfileNoScatter) nameSuffix += ";" + std::to_string(*isProfileNoScatter);
+  if (isSparse) nameSuffix += ";sparse" + std::to_string(*isSparse);
   nameSuffix += "}";
   return nameSuffix;
 }
@@ -2167,12 +2195,20 @@ Plot::Pad::Ratio::Ratio(const ptree& dataTree) : Data(dataTree)
           dataDims.push_back({vars->at(i), nBins, edges});
         }
       }
+      optional<vector<uint8_t>> binningModes;
+      read_from_tree(dataTree, binningModes, "denomData_binning_modes");
+      if (binningModes && binningModes->size() == dataDims.size()) {
+        for (int i = 0; i < dataDims.size(); ++i) {
+          dataDims[i].binning = static_cast<binning_t>((*binningModes)[i]);
+        }
+      }
       mDenomDataInfo.dataDims = dataDims;
       read_from_tree(dataTree, mDenomDataInfo.filters, "denomData_filters");
       read_from_tree(dataTree, mDenomDataInfo.weight, "denomData_weight");
       read_from_tree(dataTree, mDenomDataInfo.entries.min, "denomData_entryMin");
       read_from_tree(dataTree, mDenomDataInfo.entries.max, "denomData_entryMax");
       read_from_tree(dataTree, mDenomDataInfo.isProfileNoScatter, "denomData_isProfileNoScatter");
+      read_from_tree(dataTree, mDenomDataInfo.isSparse, "denomData_isSparse");
     }
   }
   // extract proj info
@@ -2208,20 +2244,26 @@ ptree Plot::Pad::Ratio::GetPropertyTree() const
     vector<string> vars;
     vector<double_t> binning;
     vector<int32_t> sizes;
+    vector<uint8_t> binningModes;
     for (const auto& dataDim : mDenomDataInfo.dataDims) {
       vars.push_back(dataDim.var);
       binning.insert(binning.end(), dataDim.edges.begin(), dataDim.edges.end());
       binning.push_back(static_cast<double_t>(dataDim.nBins));
       sizes.push_back(static_cast<int32_t>(dataDim.edges.size()) + 1);
+      binningModes.push_back(dataDim.binning);
     }
     put_in_tree(dataTree, optional<vector<string>>{vars}, "denomData_vars");
     put_in_tree(dataTree, optional<vector<double_t>>{binning}, "denomData_binning");
     put_in_tree(dataTree, optional<vector<int32_t>>{sizes}, "denomData_binning_sizes");
+    if (std::any_of(binningModes.begin(), binningModes.end(), [](uint8_t mode) { return mode != uniform; })) {
+      put_in_tree(dataTree, optional<vector<uint8_t>>{binningModes}, "denomData_binning_modes");
+    }
     put_in_tree(dataTree, mDenomDataInfo.filters, "denomData_filters");
     put_in_tree(dataTree, mDenomDataInfo.weight, "denomData_weight");
     put_in_tree(dataTree, mDenomDataInfo.entries.min, "denomData_entryMin");
     put_in_tree(dataTree, mDenomDataInfo.entries.max, "denomData_entryMax");
     put_in_tree(dataTree, mDenomDataInfo.isProfileNoScatter, "denomData_isProfileNoScatter");
+    put_in_tree(dataTree, mDenomDataInfo.isSparse, "denomData_isSparse");
   }
   if (mDenomProjInfo) {
     put_in_tree(dataTree, optional<vector<uint8_t>>{mDenomProjInfo->dims}, "denomProj_dims");
@@ -2426,6 +2468,14 @@ auto Plot::Pad::Ratio::Entries(uint32_t entryMin, uint32_t entryMax) -> decltype
   mDenomDataInfo.entries.max = entryMax;
   return *this;
 }
+auto Plot::Pad::Ratio::Sparse(bool sparse) -> decltype(*this)
+{
+  if (mModMode == Mode::Num) {
+    return static_cast<decltype(*this)&>(Data::Sparse(sparse));
+  }
+  mDenomDataInfo.isSparse = sparse;
+  return *this;
+}
 
 //--------------------------------------------------------------------------------------------------
 //--------------------------------------------------------------------------------------------------
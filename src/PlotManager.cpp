@@ -18,9 +18,11 @@
 
 #include "SciRooPlot/PlotManager.h"
 
+#include "SciRooPlot/DataIndex.h"
 #include "SciRooPlot/Helpers.h"
 #include "SciRooPlot/Logging.h"
 #include "SciRooPlot/PlotPainter.h"
+#include "SciRooPlot/Profiler.h"
 
 #include <ROOT/RCsvDS.hxx>
 #include <ROOT/RDataFrame.hxx>
@@ -33,23 +35,54 @@
 #include <TFile.h>
 #include <TFolder.h>
 #include <TGraph2D.h>
+#include <TGraphAsymmErrors.h>
 #include <TGraphErrors.h>
 #include <TH1.h>
+#include <THnSparse.h>
 #include <TKey.h>
+#include <TList.h>
 #include <TPave.h>
+#include <TProfile.h>
 #include <TROOT.h>
 #include <TRootCanvas.h>
+#include <TStyle.h>
 #include <TSystem.h>
 #include <TTree.h>
 
 #include <boost/property_tree/info_parser.hpp>
 
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#ifdef SCIROOPLOT_HAVE_MEMFD_CREATE
+#include <sys/mman.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <regex>
 #include <set>
+#include <sstream>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -63,26 +96,92 @@ using std::set;
 using std::shared_ptr;
 using std::string;
 using std::tuple;
+using std::unique_ptr;
 using std::unordered_map;
 using std::vector;
 
 namespace SciRooPlot
 {
+namespace
+{
+// the ROOT graphics state (gPad, gStyle, colors) is global, so managers running in parallel (e.g. from python threads) paint one plot at a time
+std::mutex gPaintMutex;
+
+volatile std::sig_atomic_t gStopSignal{};
+
+// starts the line the plot server sends after the output of a request (followed by the exit code)
+const char* const gServerStatusMarker = "\x1eSRP_STATUS ";
+
+//**************************************************************************************************
+/**
+ * Catches SIGINT and SIGTERM while long-running loops (watch mode, plot server) are active, such that they can shut down cleanly.
+ * The previous handlers are restored afterwards and a caught signal is passed on to a previous custom handler (e.g. the one of python).
+ */
+//**************************************************************************************************
+class StopSignalHandler
+{
+ public:
+  StopSignalHandler()
+  {
+    gStopSignal = 0;
+    struct sigaction action{};
+    action.sa_handler = [](int32_t caughtSignal) { gStopSignal = caughtSignal; };
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;  // no SA_RESTART, so blocking calls return when the signal arrives
+    sigaction(SIGINT, &action, &mPreviousInt);
+    sigaction(SIGTERM, &action, &mPreviousTerm);
+  }
+  ~StopSignalHandler()
+  {
+    sigaction(SIGINT, &mPreviousInt, nullptr);
+    sigaction(SIGTERM, &mPreviousTerm, nullptr);
+    int32_t caughtSignal = gStopSignal;
+    gStopSignal = 0;
+    const auto& previous = (caughtSignal == SIGINT) ? mPreviousInt : mPreviousTerm;
+    if (caughtSignal && previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) std::raise(caughtSignal);
+  }
+  StopSignalHandler(const StopSignalHandler&) = delete;
+  StopSignalHandler& operator=(const StopSignalHandler&) = delete;
+
+  bool IsStopRequested() const { return gStopSignal != 0; }
+
+ private:
+  struct sigaction mPreviousInt{};
+  struct sigaction mPreviousTerm{};
+};
+}  // namespace
 
 //**************************************************************************************************
 /**
  * Constructor for PlotManager.
  */
 //**************************************************************************************************
-PlotManager::PlotManager(const std::string& projectName) : mApp(new TApplication("MainApp", 0, nullptr)), mProjectName(projectName)
+PlotManager::PlotManager(const std::string& projectName) : mProjectName(projectName)
 {
-  ROOT::EnableImplicitMT();
   gROOT->SetWebDisplay("off");
   gErrorIgnoreLevel = kWarning;
 
   if (!projectName.empty() && Config::Get().Exists(projectName)) {
     mOutputDirectory = Config::Get().OutputDir(projectName);
   }
+}
+
+PlotManager::~PlotManager()
+{
+  Profiler::Get().Enable(this, false);
+}
+
+//**************************************************************************************************
+/**
+ * Creates the application and sets up the graphics environment needed to display plots.
+ * This is done only once the first plot is shown, since it is expensive and not needed in batch mode.
+ */
+//**************************************************************************************************
+void PlotManager::InitApplication()
+{
+  if (mApp) return;
+  mApp.reset(new TApplication("MainApp", 0, nullptr));
+  gROOT->SetBatch(false);
 
   // determine OS dependent offset between window and frame
   // (GetWindowTopY gives the current coordinates of the window, but SetWindowPosition moves the frame instead of the window)
@@ -141,18 +240,22 @@ void PlotManager::SavePlotsToRootFile() const
 
 //**************************************************************************************************
 /**
- * Save buffered data .root file.
+ * Save buffered data of the selected plots to .root file.
  */
 //**************************************************************************************************
-void PlotManager::SaveDataToRootFile() const
+void PlotManager::SaveDataToRootFile(const map<string, set<string>>& selectedData) const
 {
   TFile outputFile((mOutputDirectory + "/" + mDataRootFile).data(), "RECREATE");
   if (outputFile.IsZombie()) {
     return;
   }
-  for (const auto& [dataSource, buffer] : mDataBuffer) {
-    for (const auto& [dataName, dataPtr] : buffer) {
-      if (!dataPtr) continue;
+  for (const auto& [dataSource, dataNames] : selectedData) {
+    auto buffer = mDataBuffer.find(dataSource);
+    if (buffer == mDataBuffer.end()) continue;
+    for (const auto& dataName : dataNames) {
+      auto data = buffer->second.find(dataName);
+      if (data == buffer->second.end() || !data->second) continue;
+      const auto& dataPtr = data->second;
       auto dir = outputFile.mkdir(dataSource.data(), "", true);
       string name = split_string(dataPtr->GetName(), ':')[0];
       auto tokens = split_string(name, '/');
@@ -182,6 +285,57 @@ void PlotManager::SetOutputDirectory(const string& path)
   mOutputDirectory = path;
 }
 
+//**************************************************************************************************
+/**
+ * Enables removal of markers that overlap exactly at the canvas resolution when saving vector formats (pdf, svg, eps, ps).
+ */
+//**************************************************************************************************
+void PlotManager::SetDecimateVectorMarkers(bool decimate)
+{
+  mDecimateVectorMarkers = decimate;
+}
+
+//**************************************************************************************************
+/**
+ * Enables incremental mode in which existing output files are only re-generated if the plot definition or its input files changed.
+ */
+//**************************************************************************************************
+void PlotManager::SetIncrementalBuild(bool incremental)
+{
+  mIncrementalBuild = incremental;
+}
+
+//**************************************************************************************************
+/**
+ * Reports time and memory spent in the individual stages of generating plots (optionally also as trace file).
+ * Since the profiler is shared by the whole process, only one plot manager can profile at a time.
+ */
+//**************************************************************************************************
+void PlotManager::SetProfiling(bool profile, const string& traceFile)
+{
+  if (!Profiler::Get().Enable(this, profile, traceFile)) {
+    WARNING("Profiling is already enabled for another plot manager. Disable it there first.");
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Reports bytes read, keys scanned and objects deserialized per data source and input file after reading the data.
+ * The report can be sorted by time, bytes, keys, objects, deep (lookups that required traversing sub-directories) or name.
+ */
+//**************************************************************************************************
+void PlotManager::SetLoadReport(bool report, const string& sortBy)
+{
+  mLoadReport = report;
+  const vector<string> sortKeys{"time", "bytes", "keys", "objects", "deep", "name"};
+  if (std::find(sortKeys.begin(), sortKeys.end(), sortBy) == sortKeys.end()) {
+    WARNING("Cannot sort data loading report by {}. Sorting by time instead.", sortBy);
+    mLoadReportSortBy = "time";
+    return;
+  }
+  mLoadReportSortBy = sortBy;
+}
+
 //**************************************************************************************************
 /**
  * Define input file paths for user defined dataSource.
@@ -248,6 +402,30 @@ void PlotManager::AddDataSource(const string& dataSource, TObject* inputData)
   AddDataSource(dataSource, vector<TObject*>{inputData});
 }
 
+//**************************************************************************************************
+/**
+ * Define an in-memory table (e.g. from pandas) as data of a dataSource. The columns are read in place when processing the table
+ * in the same way as trees or table files. The table only lives as long as the manager and is not stored with the dataSources.
+ */
+//**************************************************************************************************
+void PlotManager::AddDataSource(const string& dataSource, const string& tableName, table_t columns)
+{
+  if (columns.empty()) {
+    WARNING("Table {} has no columns. Skipping.", tableName);
+    return;
+  }
+  auto getSize = [](const column_t& column) { return std::visit([](const auto& values) { return values.size(); }, column.values); };
+  for (const auto& [columnName, column] : columns) {
+    if (getSize(column) != getSize(columns.begin()->second)) {
+      ERROR("Column {} of table {} has a different length than the other columns.", columnName, tableName);
+      return;
+    }
+  }
+  mTables[dataSource][tableName] = std::move(columns);
+  // discard data processed from a previous version of the table
+  mDataBuffer.erase(dataSource);
+}
+
 //**************************************************************************************************
 /**
  * Save dataSource properties currently defined in the manager to a config file.
@@ -278,6 +456,7 @@ void PlotManager::SaveDataSources(const optional<string>& file) const
 //**************************************************************************************************
 void PlotManager::LoadDataSources(const optional<string>& file)
 {
+  Profiler::Scope profileScope("LoadDataSources");
   ptree inputFileTree;
   try {
     using boost::property_tree::read_info;
@@ -434,10 +613,12 @@ void PlotManager::SavePlots(const string& name, const string& group, const optio
 //**************************************************************************************************
 /**
  * Function to load plots matching name and group regex from file.
+ * All base plots are loaded, since saving the plots afterwards would otherwise drop the unreferenced ones.
  */
 //**************************************************************************************************
 void PlotManager::LoadPlots(const string& name, const string& group, const optional<string>& file)
 {
+  Profiler::Scope profileScope("LoadPlots");
   uint32_t nFoundPlots{};
 
   RegexMatcher groupRegex(group, Config::Get().MatchContains(), Config::Get().MatchCaseInsensitive());
@@ -483,10 +664,10 @@ void PlotManager::LoadPlots(const string& name, const string& group, const optio
 
 //**************************************************************************************************
 /**
- * Generates plots matching name and group regex.
+ * Generates plots matching name and group regex. Returns false if data are missing or any of the plots could not be created.
  */
 //**************************************************************************************************
-void PlotManager::GeneratePlots(const string& mode, const string& name, const string& group)
+bool PlotManager::GeneratePlots(const string& mode, const string& name, const string& group)
 {
   // first determine which data needs to be loaded
   vector<Plot*> selectedPlots;
@@ -496,72 +677,470 @@ void PlotManager::GeneratePlots(const string& mode, const string& name, const st
   RegexMatcher nameRegex(name, Config::Get().MatchContains(), Config::Get().MatchCaseInsensitive());
   if (!groupRegex.IsValid() || !nameRegex.IsValid()) {
     ERROR("Invalid regular expression.");
-    return;
+    return false;
   }
 
+  bool isIncremental = mIncrementalBuild && (std::find(mFileFormats.begin(), mFileFormats.end(), mode) != mFileFormats.end());
+  uint32_t nUpToDate{};
   for (auto& plot : mPlots) {
     if (!groupRegex.Matches(plot.GetGroup())) continue;
     if (!nameRegex.Matches(plot.GetName())) continue;
+    if (isIncremental) {
+      // skip plots that are up to date before their data are even loaded
+      Plot fullPlot = GetFullPlot(plot);
+      if (IsUpToDate(fullPlot, GetOutputFilePath(plot, "." + mode))) {
+        ++nUpToDate;
+        continue;
+      }
+    }
     selectedPlots.push_back(&plot);
+  }
+
+  if (nUpToDate) {
+    INFO("Skipping {} plots that are already up to date.", nUpToDate);
+  }
+  if (selectedPlots.empty()) {
+    if (!nUpToDate) ERROR("No plots were created.");
+    return nUpToDate > 0;
+  }
+
+  bool success = GenerateSelectedPlots(selectedPlots, mode);
+  Profiler::Get().Report(this);
+  return success;
+}
+
+//**************************************************************************************************
+/**
+ * Generates plots matching name and group regex and keeps re-generating them whenever their input files
+ * or the plot definitions change. Only the data of modified inputs are re-loaded.
+ */
+//**************************************************************************************************
+void PlotManager::WatchPlots(const string& mode, const string& name, const string& group)
+{
+#ifdef __linux__
+  int32_t inotifyFd = inotify_init1(IN_NONBLOCK);
+  if (inotifyFd < 0) {
+    ERROR("Cannot watch files for changes.");
+    return;
+  }
+  mIsWatching = true;
+  GeneratePlots(mode, name, group);
+
+  // directories are watched instead of files, since output files are often replaced rather than modified
+  map<int32_t, string> watchedDirs;
+  auto watchFile = [&](const string& fileName) {
+    string dirName = std::filesystem::path(expand_path(fileName)).parent_path().string();
+    int32_t watchDescriptor = inotify_add_watch(inotifyFd, dirName.data(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watchDescriptor >= 0) {
+      watchedDirs[watchDescriptor] = dirName;
+    } else {
+      WARNING("Cannot watch {} for changes.", dirName);
+    }
+  };
+  const string plotsFile = expand_path(Config::Get().PlotsFile(mProjectName));
+  watchFile(plotsFile);
+  for (const auto& [dataSource, inputFiles] : mInputFiles) {
+    for (const auto& inputFileName : inputFiles) {
+      watchFile(split_string(inputFileName, ':')[0]);
+    }
+  }
+  INFO("Watching plot definitions and input files for changes... (stop with Ctrl+C)");
+
+  auto getDefinition = [&](const Plot& plot) {
+    Plot fullPlot = GetFullPlot(plot);
+    std::ostringstream plotDefinition;
+    boost::property_tree::write_info(plotDefinition, fullPlot.GetPropertyTree());
+    return plotDefinition.str();
+  };
+
+  // the keys of root files tell which of the buffered data were modified
+  map<string, map<string, string>> keyFingerprints;  // input file -> key path -> fingerprint
+  for (const auto& [dataSource, inputFiles] : mInputFiles) {
+    for (const auto& inputFileName : inputFiles) {
+      if (str_contains(inputFileName, ".root", true)) keyFingerprints[inputFileName] = GetKeyFingerprints(inputFileName);
+    }
+  }
+
+  StopSignalHandler stopSignalHandler;
+  alignas(inotify_event) char eventBuffer[4096];
+  while (!stopSignalHandler.IsStopRequested()) {
+    if (mode == "show") gSystem->ProcessEvents();
+    gSystem->Sleep(50);
+    set<string> changedFiles;
+    auto readEvents = [&]() {
+      ssize_t length{};
+      while ((length = read(inotifyFd, eventBuffer, sizeof(eventBuffer))) > 0) {
+        for (char* eventPtr = eventBuffer; eventPtr < eventBuffer + length;) {
+          auto event = reinterpret_cast<inotify_event*>(eventPtr);
+          if (event->len) changedFiles.insert(watchedDirs[event->wd] + "/" + event->name);
+          eventPtr += sizeof(inotify_event) + event->len;
+        }
+      }
+    };
+    readEvents();
+    if (changedFiles.empty()) continue;
+    // wait until the writing of all files belonging to the same change is finished
+    gSystem->Sleep(200);
+    readEvents();
+
+    // drop buffered data (and the data processed from them) that stem from modified keys of the input files, so they will be re-read
+    map<string, set<string>> invalidatedData;  // dataSource -> names in data buffer
+    for (const auto& [dataSource, inputFiles] : mInputFiles) {
+      auto buffer = mDataBuffer.find(dataSource);
+      if (buffer == mDataBuffer.end()) continue;
+      for (const auto& inputFileName : inputFiles) {
+        if (!changedFiles.count(expand_path(split_string(inputFileName, ':')[0]))) continue;
+        if (!str_contains(inputFileName, ".root", true)) {
+          // tables are read as a whole
+          for (const auto& [dataName, dataPtr] : buffer->second) {
+            invalidatedData[dataSource].insert(dataName);
+          }
+          continue;
+        }
+        auto& previousKeys = keyFingerprints[inputFileName];
+        const auto& currentKeys = GetKeyFingerprints(inputFileName);
+        set<string> changedKeys;
+        for (const auto& [keyPath, fingerprint] : currentKeys) {
+          auto previousKey = previousKeys.find(keyPath);
+          if (previousKey == previousKeys.end() || previousKey->second != fingerprint) changedKeys.insert(keyPath);
+        }
+        for (const auto& [keyPath, fingerprint] : previousKeys) {
+          if (!currentKeys.count(keyPath)) changedKeys.insert(keyPath);
+        }
+        previousKeys = currentKeys;
+        // data are invalidated by the key they were actually read from (which may be a list or found only by traversing the file)
+        set<string> invalidatedNames;
+        for (const auto& [dataName, keyPath] : mDataKeys[dataSource]) {
+          if (changedKeys.count(keyPath)) invalidatedNames.insert(dataName);
+        }
+        // data processed from modified trees start with the name of the tree
+        for (const auto& [dataName, dataPtr] : buffer->second) {
+          for (const auto& invalidatedName : invalidatedNames) {
+            if (dataName.compare(0, invalidatedName.size(), invalidatedName) == 0) invalidatedData[dataSource].insert(dataName);
+          }
+        }
+      }
+    }
+    for (const auto& [dataSource, dataNames] : invalidatedData) {
+      for (const auto& dataName : dataNames) {
+        mDataBuffer[dataSource].erase(dataName);
+      }
+    }
+
+    // re-load plot definitions and find the ones that changed
+    set<string> changedPlots;
+    if (changedFiles.count(plotsFile)) {
+      map<string, string> previousDefinitions;
+      for (const auto& plot : mPlots) {
+        previousDefinitions[plot.GetUniqueName()] = getDefinition(plot);
+      }
+      mPlots.clear();
+      mBasePlots.clear();
+      LoadPlots(name, group);
+      for (const auto& plot : mPlots) {
+        auto previousDefinition = previousDefinitions.find(plot.GetUniqueName());
+        if (previousDefinition == previousDefinitions.end() || previousDefinition->second != getDefinition(plot)) {
+          changedPlots.insert(plot.GetUniqueName());
+        }
+      }
+    }
+
+    RegexMatcher groupRegex(group, Config::Get().MatchContains(), Config::Get().MatchCaseInsensitive());
+    RegexMatcher nameRegex(name, Config::Get().MatchContains(), Config::Get().MatchCaseInsensitive());
+    vector<Plot*> affectedPlots;
+    for (auto& plot : mPlots) {
+      if (!groupRegex.Matches(plot.GetGroup()) || !nameRegex.Matches(plot.GetName())) continue;
+      bool isAffected = changedPlots.count(plot.GetUniqueName());
+      Plot fullPlot = GetFullPlot(plot);
+      for (const auto& [dataSource, dataNames] : GetRequiredData(fullPlot)) {
+        auto invalidated = invalidatedData.find(dataSource);
+        if (invalidated == invalidatedData.end()) continue;
+        for (const auto& dataName : dataNames) {
+          // processed data are buffered with a suffix to their name
+          auto candidate = invalidated->second.lower_bound(dataName);
+          isAffected |= (candidate != invalidated->second.end() && candidate->compare(0, dataName.size(), dataName) == 0);
+        }
+      }
+      if (isAffected) affectedPlots.push_back(&plot);
+    }
+    if (affectedPlots.empty()) continue;
+    INFO("Re-generating {} plots affected by changes in {}.", affectedPlots.size(), vector_to_string(vector<string>(changedFiles.begin(), changedFiles.end())));
+    GenerateSelectedPlots(affectedPlots, mode);
+    Profiler::Get().Report(this);
+  }
+  close(inotifyFd);
+  mIsWatching = false;
+  INFO("Stopped watching for changes.");
+#else
+  ERROR("Watch mode is only supported on Linux.");
+#endif
+}
+
+//**************************************************************************************************
+/**
+ * Keeps the plot definitions and the loaded data of the project resident and generates plots on request
+ * of other processes (see ForwardToServer) that connect via a unix domain socket.
+ * Plot definitions, dataSources and buffered data are refreshed whenever the corresponding files change.
+ */
+//**************************************************************************************************
+void PlotManager::ServePlots()
+{
+  sockaddr_un address{};
+  if (!GetServerAddress(mProjectName, address)) return;
+  int32_t serverFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (serverFd < 0) {
+    ERROR("Could not create socket.");
+    return;
+  }
+  if (connect(serverFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) {
+    ERROR("A plot server is already running for project {}.", mProjectName);
+    close(serverFd);
+    return;
+  }
+  unlink(address.sun_path);  // socket file of a server that did not shut down properly
+  if (bind(serverFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(serverFd, 8) < 0) {
+    ERROR("Could not start plot server on {}.", address.sun_path);
+    close(serverFd);
+    return;
+  }
+  // do not die when a client disconnects while its plots are still being generated
+  std::signal(SIGPIPE, SIG_IGN);
+  StopSignalHandler stopSignalHandler;
+
+  const string plotsFile = expand_path(Config::Get().PlotsFile(mProjectName));
+  const string dataSourcesFile = expand_path(Config::Get().DataSourcesFile(mProjectName));
+  map<string, string> fileFingerprints;
+  auto isModified = [&](const string& fileName) {
+    string fingerprint = GetFileFingerprint(fileName);
+    bool modified = (fileFingerprints[fileName] != fingerprint);
+    fileFingerprints[fileName] = fingerprint;
+    return modified;
+  };
+  INFO("Plot server for project {} is listening on {}.", mProjectName, address.sun_path);
+
+  while (!stopSignalHandler.IsStopRequested()) {
+    int32_t clientFd = accept(serverFd, nullptr, nullptr);
+    if (clientFd < 0) continue;
+    // clients that do not send their request in time must not block the server
+    timeval timeout{5, 0};
+    setsockopt(clientFd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    string request;
+    char character{};
+    while (read(clientFd, &character, 1) == 1 && character != '\n') {
+      request += character;
+    }
+    auto requestArgs = split_string(request, '\t');
+    if (requestArgs.size() != 5 || requestArgs[0] != "GeneratePlots") {
+      close(clientFd);
+      continue;
+    }
+    const string& mode = requestArgs[1];
+    const string& name = requestArgs[2];
+    const string& group = requestArgs[3];
+    INFO("Generating {} {} {}.", group, name, mode);
+    // only the canvases of the current request are written to file
+    mCanvasRegistry.clear();
+
+    // bring definitions and data up to date with the files on disk
+    if (isModified(plotsFile)) {
+      mPlots.clear();
+      mBasePlots.clear();
+      LoadPlots();
+    }
+    if (isModified(dataSourcesFile)) {
+      mInputFiles.clear();
+      mDataBuffer.clear();
+      mDataKeys.clear();
+      LoadDataSources();
+    }
+    for (const auto& [dataSource, inputFiles] : mInputFiles) {
+      for (const auto& inputFileName : inputFiles) {
+        if (!isModified(split_string(inputFileName, ':')[0])) continue;
+        mDataBuffer.erase(dataSource);
+        mDataKeys.erase(dataSource);
+      }
+    }
+
+    // all output produced while generating the plots is sent to the client
+    fflush(stdout);
+    fflush(stderr);
+    int32_t stdoutFd = dup(STDOUT_FILENO);
+    int32_t stderrFd = dup(STDERR_FILENO);
+    dup2(clientFd, STDOUT_FILENO);
+    dup2(clientFd, STDERR_FILENO);
+    bool success = false;
+    try {
+      if (mode == "show") {
+        ERROR("Interactive mode is not supported by the plot server.");
+      } else {
+        SetIncrementalBuild(requestArgs[4] == "1");
+        success = GeneratePlots(mode, name, group);
+      }
+    } catch (...) {
+      ERROR("Exception while generating plots.");
+    }
+    fflush(stdout);
+    fflush(stderr);
+    dup2(stdoutFd, STDOUT_FILENO);
+    dup2(stderrFd, STDERR_FILENO);
+    close(stdoutFd);
+    close(stderrFd);
+    // the outcome is sent last, so the client can report it in its exit code
+    string status = fmt::format("{}{}\n", gServerStatusMarker, success ? EXIT_SUCCESS : EXIT_FAILURE);
+    if (write(clientFd, status.data(), status.size()) != static_cast<ssize_t>(status.size())) {
+      WARNING("Could not send the status of the request to the client.");
+    }
+    close(clientFd);
+    mCanvasRegistry.clear();
+  }
+  close(serverFd);
+  unlink(address.sun_path);
+  INFO("Plot server for project {} was stopped.", mProjectName);
+}
+
+//**************************************************************************************************
+/**
+ * Sends a request to generate plots to the plot server of the project (if running) and prints its output.
+ * Returns the exit code reported by the server or nothing if no server is available.
+ */
+//**************************************************************************************************
+optional<int32_t> PlotManager::ForwardToServer(const string& projectName, const string& mode, const string& name, const string& group, bool incremental)
+{
+  sockaddr_un address{};
+  if (!std::filesystem::exists(Config::Get().ServerSocketFile(projectName))) return std::nullopt;
+  if (!GetServerAddress(projectName, address)) return std::nullopt;
+  int32_t clientFd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (clientFd < 0) return std::nullopt;
+  if (connect(clientFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+    close(clientFd);
+    return std::nullopt;
+  }
+  string request = fmt::format("GeneratePlots\t{}\t{}\t{}\t{}\n", mode, name, group, static_cast<int32_t>(incremental));
+  if (write(clientFd, request.data(), request.size()) != static_cast<ssize_t>(request.size())) {
+    close(clientFd);
+    return std::nullopt;
+  }
+  // output is printed line by line, the last line holds the status of the request
+  int32_t exitCode = EXIT_FAILURE;  // in case the server did not finish the request
+  string output;
+  auto printLine = [&](const string& line) {
+    auto markerPos = line.find(gServerStatusMarker);
+    if (markerPos == string::npos) {
+      fwrite(line.data(), 1, line.size(), stdout);
+      return;
+    }
+    if (markerPos > 0) fmt::print("{}\n", line.substr(0, markerPos));
+    exitCode = std::atoi(line.data() + markerPos + std::strlen(gServerStatusMarker));
+  };
+  char buffer[4096];
+  ssize_t length{};
+  while ((length = read(clientFd, buffer, sizeof(buffer))) > 0) {
+    output.append(buffer, length);
+    size_t lineEnd{};
+    while ((lineEnd = output.find('\n')) != string::npos) {
+      printLine(output.substr(0, lineEnd + 1));
+      output.erase(0, lineEnd + 1);
+    }
+  }
+  printLine(output);
+  fflush(stdout);
+  close(clientFd);
+  return exitCode;
+}
+
+//**************************************************************************************************
+/**
+ * Determines the address of the socket the plot server of a project is listening on.
+ */
+//**************************************************************************************************
+bool PlotManager::GetServerAddress(const string& projectName, sockaddr_un& address)
+{
+  string socketFile = Config::Get().ServerSocketFile(projectName);
+  if (socketFile.empty() || socketFile.size() >= sizeof(address.sun_path)) {
+    ERROR("Invalid socket path {} for plot server.", socketFile);
+    return false;
+  }
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socketFile.data(), sizeof(address.sun_path) - 1);
+  return true;
+}
 
+//**************************************************************************************************
+/**
+ * Loads the data required by the selected plots (if not yet in buffer) and generates them.
+ * Returns false if data are missing or any of the plots could not be created.
+ */
+//**************************************************************************************************
+bool PlotManager::GenerateSelectedPlots(const vector<Plot*>& selectedPlots, const string& mode)
+{
+  Profiler::Scope profileScope("GeneratePlots");
+  // names of the (processed) data used by the selected plots
+  map<string, set<string>> selectedData;
+  auto requireData = [&](const string& dataSource, const string& dataName) {
+    mDataBuffer[dataSource][dataName];
+    selectedData[dataSource].insert(dataName);
+  };
+  auto requireDataInfo = [&](const string& dataSource, const string& dataName, const Plot::Pad::Data::data_info_t& dataInfo) {
+    if (dataInfo.dataDims.empty()) return;
+    auto& dataInfos = mDataInfoBuffer[dataSource][dataName];
+    auto iter = std::find_if(dataInfos.begin(), dataInfos.end(), [&](const auto& bufferedInfo) { return bufferedInfo.GetNameSuffix() == dataInfo.GetNameSuffix(); });
+    if (iter == dataInfos.end()) dataInfos.push_back(dataInfo);
+    selectedData[dataSource].insert(dataName + dataInfo.GetNameSuffix());
+  };
+  for (auto plot : selectedPlots) {
     // determine which input data are needed for plots
-    for (auto& [padID, pad] : plot.GetPads()) {
+    for (auto& [padID, pad] : plot->GetPads()) {
       if (auto& refFunc = pad.GetRefFunc()) {
-        mDataBuffer[refFunc->GetDataSource()][refFunc->GetName()];
+        requireData(refFunc->GetDataSource(), refFunc->GetName());
       } else {
-        if (plot.GetBasePlotName()) {
-          auto it = std::find_if(mBasePlots.begin(), mBasePlots.end(), [&](const auto& basePlot) { return *plot.GetBasePlotName() == basePlot.GetName(); });
+        if (plot->GetBasePlotName()) {
+          auto it = std::find_if(mBasePlots.begin(), mBasePlots.end(), [&](const auto& basePlot) { return *plot->GetBasePlotName() == basePlot.GetName(); });
           if (it != mBasePlots.end()) {
             if (auto& refFunc = (*it).GetPad(padID).GetRefFunc()) {
-              mDataBuffer[refFunc->GetDataSource()][refFunc->GetName()];
+              requireData(refFunc->GetDataSource(), refFunc->GetName());
             }
           }
         }
       }
       for (const auto& data : pad.GetData()) {
-        mDataBuffer[data->GetDataSource()][data->GetName()];
-        if (data->GetDataInfo().dataDims.size()) {
-          auto& dataInfos = mDataInfoBuffer[data->GetDataSource()][data->GetName()];
-          auto iter = std::find_if(dataInfos.begin(), dataInfos.end(), [&](const auto& dataInfo) { return dataInfo.GetNameSuffix() == data->GetDataInfo().GetNameSuffix(); });
-          if (iter == dataInfos.end()) {
-            mDataInfoBuffer[data->GetDataSource()][data->GetName()].push_back(data->GetDataInfo());
-          }
-        }
+        requireData(data->GetDataSource(), data->GetName());
+        requireDataInfo(data->GetDataSource(), data->GetName(), data->GetDataInfo());
         if (data->GetType() == "ratio") {
           const auto& ratio = std::dynamic_pointer_cast<Plot::Pad::Ratio>(data);
-          mDataBuffer[ratio->GetDenomDataSource()][ratio->GetDenomName()];
-          if (ratio->GetDenomDataInfo().dataDims.size()) {
-            auto& dataInfos = mDataInfoBuffer[ratio->GetDenomDataSource()][ratio->GetDenomName()];
-            auto iter = std::find_if(dataInfos.begin(), dataInfos.end(), [&](const auto& dataInfo) { return dataInfo.GetNameSuffix() == ratio->GetDenomDataInfo().GetNameSuffix(); });
-            if (iter == dataInfos.end()) {
-              mDataInfoBuffer[ratio->GetDenomDataSource()][ratio->GetDenomName()].push_back(ratio->GetDenomDataInfo());
-            }
-          }
+          requireData(ratio->GetDenomDataSource(), ratio->GetDenomName());
+          requireDataInfo(ratio->GetDenomDataSource(), ratio->GetDenomName(), ratio->GetDenomDataInfo());
         }
       }
     }
   }
 
-  if (selectedPlots.empty()) {
-    ERROR("No plots were created.");
-    return;
-  }
-
+  bool success = true;
   try {
-    if (!FillBuffer()) PrintBufferStatus(true);
+    // printing the plot definitions does not require any input data
+    if (mode != "print") {
+      if (!FillBuffer()) {
+        PrintBufferStatus(true);
+        success = false;
+      }
+      if (mLoadReport) PrintLoadReport();
+    }
     // generate plots
     for (auto plot : selectedPlots) {
-      if (!GeneratePlot(*plot, mode))
+      if (!GeneratePlot(*plot, mode)) {
         ERROR("Plot {}{}{} from group {}{}{} could not be created.", logger::begin_color(logger::Color::Green), plot->GetName(), logger::end_color(), logger::begin_color(logger::Color::Yellow), plot->GetGroup(), logger::end_color());
+        success = false;
+      }
     }
     if (mode == "file") {
       SavePlotsToRootFile();
     } else if (mode == "data") {
-      SaveDataToRootFile();
+      SaveDataToRootFile(selectedData);
     }
   } catch (...) {
     ERROR("An unexpected error occurred. The application will now exit.");
+    success = false;
   }
+  return success;
 }
 
 //**************************************************************************************************
@@ -571,8 +1150,17 @@ void PlotManager::GeneratePlots(const string& mode, const string& name, const st
 //**************************************************************************************************
 bool PlotManager::FillBuffer()
 {
+  Profiler::Scope profileScope("FillBuffer");
+  // the thread pool is started only once data actually need to be read (and only once if several managers read data in parallel)
+  static std::once_flag implicitMTFlag;
+  std::call_once(implicitMTFlag, []() {
+    if (!ROOT::IsImplicitMTEnabled()) ROOT::EnableImplicitMT();
+  });
   bool success = true;
+  mLoadStats.clear();
+  auto secondsSince = [](std::chrono::steady_clock::time_point start) { return std::chrono::duration<double_t>(std::chrono::steady_clock::now() - start).count(); };
   for (auto& [dataSource, buffer] : mDataBuffer) {
+    Profiler::Scope dataSourceScope("ReadDataSource", dataSource);
     unordered_map<string, vector<string>> requiredData;  // subdir, names
     for (auto& [dataName, dataPtr] : buffer) {
       if (dataPtr) continue;
@@ -622,15 +1210,48 @@ bool PlotManager::FillBuffer()
       requiredData[std::move(path)].push_back(std::move(name));
     }
 
+    auto countRequiredData = [&]() {
+      uint32_t nRequired{};
+      for (const auto& [path, names] : requiredData) {
+        nRequired += names.size();
+      }
+      return nRequired;
+    };
+
+    // in-memory tables do not need to be read from any file
+    if (auto tables = mTables.find(dataSource); tables != mTables.end() && requiredData.count("")) {
+      vector<string>& wantedNames = requiredData[""];
+      for (const auto& [tableName, columns] : tables->second) {
+        auto wantedName = std::find(wantedNames.begin(), wantedNames.end(), tableName);
+        if (wantedName == wantedNames.end()) continue;
+        auto start = std::chrono::steady_clock::now();
+        auto& stats = mLoadStats[dataSource]["memory:" + tableName];
+        stats.requested = countRequiredData();
+        wantedNames.erase(wantedName);
+        ReadMemoryTable(tableName, columns, dataSource);
+        stats.found = 1;
+        stats.time = secondsSince(start);
+      }
+      if (wantedNames.empty()) requiredData.erase("");
+    }
+
     // open all input files belonging to the current dataSource and extract the data
     for (const auto& inputFileName : mInputFiles[dataSource]) {
       if (requiredData.empty()) break;
+      auto start = std::chrono::steady_clock::now();
       if (str_contains(inputFileName, mTableFileEndings, true)) {
+        auto& stats = mLoadStats[dataSource][inputFileName];
+        stats.requested = countRequiredData();
         string name = inputFileName.substr(inputFileName.rfind('/') + 1, inputFileName.rfind(".") - inputFileName.rfind('/') - 1);
         ReadTableData(inputFileName, name, dataSource);
         vector<string>& wantedNames = requiredData[""];
         wantedNames.erase(std::remove_if(wantedNames.begin(), wantedNames.end(), [&](const auto& wantedName) { return wantedName == name; }), wantedNames.end());
         if (wantedNames.empty()) requiredData.erase("");
+        stats.found = stats.requested - countRequiredData();
+        stats.objectsRead = 1;
+        std::error_code error;
+        stats.bytesRead = std::filesystem::file_size(inputFileName, error);
+        stats.time = secondsSince(start);
       }
       if (!str_contains(inputFileName, ".root", true)) continue;
       // check if only a sub-folder in input file should be searched
@@ -647,6 +1268,8 @@ bool PlotManager::FillBuffer()
         continue;
       }
 
+      auto& stats = mLoadStats[dataSource][inputFileName];
+      stats.requested = countRequiredData();
       TObject* folder = &inputFile;
 
       // find top level entry point for this input file
@@ -668,7 +1291,7 @@ bool PlotManager::FillBuffer()
           // recursively traverse the file and look for input files
           string prefix = (pathStr.empty()) ? "" : pathStr + "/";
           string suffix = ":" + dataSource;
-          ReadData(subfolder, names, prefix, suffix, dataSource);
+          ReadData(subfolder, names, prefix, suffix, dataSource, stats, pathStr);
           // in case a subdirectory was opened, properly delete it
           if (!path.empty() && subfolder != &inputFile) {
             delete subfolder;
@@ -686,6 +1309,9 @@ bool PlotManager::FillBuffer()
       for (const auto& pathStr : emptySubDirs) {
         requiredData.erase(pathStr);
       }
+      stats.found = stats.requested - countRequiredData();
+      stats.bytesRead = inputFile.GetBytesRead();
+      stats.time = secondsSince(start);
     }
     success &= requiredData.empty();
   }
@@ -706,6 +1332,24 @@ void PlotManager::PrintBufferStatus(bool onlyMissing) const
   }
   uint32_t nNeededData{};
   uint32_t nAvailableData{};
+  // objects with the same name elsewhere in the input files are suggested for missing data
+  DataIndex dataIndex(Config::Get().DataIndexFile(mProjectName));
+  map<string, set<string>> indexedData;
+  auto getSuggestions = [&](const string& dataSource, const string& dataName) -> string {
+    auto indexed = indexedData.find(dataSource);
+    if (indexed == indexedData.end()) indexed = indexedData.emplace(dataSource, GetIndexedData(dataIndex, dataSource)).first;
+    string baseName = dataName.substr(dataName.find_last_of('/') + 1);
+    vector<string> suggestions;
+    for (const auto& indexedName : indexed->second) {
+      if (strcasecmp(indexedName.substr(indexedName.find_last_of('/') + 1).data(), baseName.data()) == 0) suggestions.push_back(indexedName);
+    }
+    if (suggestions.empty()) return "";
+    string found = " (found " + suggestions[0];
+    for (size_t i = 1; i < std::min<size_t>(suggestions.size(), 3); ++i) {
+      found += ", " + suggestions[i];
+    }
+    return found + ((suggestions.size() > 3) ? ", ...)" : ")");
+  };
   for (const auto& [dataSource, buffer] : mDataBuffer) {
     bool printDataSource = true;
     for (const auto& [dataName, dataPtr] : buffer) {
@@ -713,16 +1357,72 @@ void PlotManager::PrintBufferStatus(bool onlyMissing) const
       bool show = onlyMissing ? (dataPtr == nullptr) : true;
       if (dataPtr) ++nAvailableData;
       if (show) {
-        if (printDataSource) INFO("{}{}", dataSource, (mInputFiles.find(dataSource) == mInputFiles.end()) ? " (dataSource not found)" : "");
+        if (printDataSource) INFO("{}{}", dataSource, (mInputFiles.find(dataSource) == mInputFiles.end() && mTables.find(dataSource) == mTables.end()) ? " (dataSource not found)" : "");
         printDataSource = false;
-        INFO(" - {}{}{}", (dataPtr) ? logger::begin_color(logger::Color::Green) : logger::begin_color(logger::Color::Red), dataName, logger::end_color());
+        INFO(" - {}{}{}{}", (dataPtr) ? logger::begin_color(logger::Color::Green) : logger::begin_color(logger::Color::Red), dataName, logger::end_color(), (dataPtr) ? "" : getSuggestions(dataSource, dataName));
       }
     }
   }
+  dataIndex.Save();
   INFO("Found {}/{} required input data.", nAvailableData, nNeededData);
   INFO("===============================================");
 }
 
+//**************************************************************************************************
+/**
+ * Show how expensive it was to read the data of each data source and input file.
+ */
+//**************************************************************************************************
+void PlotManager::PrintLoadReport() const
+{
+  if (mLoadStats.empty()) return;
+  auto sortValue = [&](const load_stats_t& stats) -> double_t {
+    if (mLoadReportSortBy == "bytes") return stats.bytesRead;
+    if (mLoadReportSortBy == "keys") return stats.keysScanned;
+    if (mLoadReportSortBy == "objects") return stats.objectsRead;
+    if (mLoadReportSortBy == "deep") return stats.deepLookups;
+    return stats.time;
+  };
+  // most expensive entries first (entries are already ordered by name)
+  auto sortEntries = [&](auto& entries) {
+    if (mLoadReportSortBy == "name") return;
+    std::stable_sort(entries.begin(), entries.end(), [&](const auto& a, const auto& b) { return sortValue(a.second) > sortValue(b.second); });
+  };
+  auto printStats = [](const load_stats_t& stats, const string& name) {
+    INFO("{:>10.2f} {:>8} {:>8} {:>6} {:>11} {:>9.3f}  {}", stats.bytesRead / 1048576., stats.keysScanned, stats.objectsRead, stats.deepLookups, fmt::format("{}/{}", stats.found, stats.requested), stats.time, name);
+  };
+
+  vector<std::pair<string, load_stats_t>> dataSources;
+  for (const auto& [dataSource, files] : mLoadStats) {
+    load_stats_t total;
+    for (const auto& [file, stats] : files) {
+      total.bytesRead += stats.bytesRead;
+      total.keysScanned += stats.keysScanned;
+      total.objectsRead += stats.objectsRead;
+      total.deepLookups += stats.deepLookups;
+      total.found += stats.found;
+      total.requested = std::max(total.requested, stats.requested);  // data not found in one file is searched for in the next
+      total.time += stats.time;
+    }
+    dataSources.push_back({dataSource, total});
+  }
+  sortEntries(dataSources);
+
+  INFO("=================================== Data Loading ===================================");
+  INFO("{:>10} {:>8} {:>8} {:>6} {:>11} {:>9}  {}", "read [MB]", "keys", "objects", "deep", "found", "time [s]", "data source / input file");
+  for (const auto& [dataSource, total] : dataSources) {
+    printStats(total, fmt::format("{}{}{}", logger::begin_color(logger::Color::Yellow), dataSource, logger::end_color()));
+    const auto& fileStats = mLoadStats.at(dataSource);
+    if (fileStats.size() < 2) continue;
+    vector<std::pair<string, load_stats_t>> files(fileStats.begin(), fileStats.end());
+    sortEntries(files);
+    for (const auto& [file, stats] : files) {
+      printStats(stats, " - " + file);
+    }
+  }
+  INFO("====================================================================================");
+}
+
 //**************************************************************************************************
 /**
  * Generates plot.
@@ -730,6 +1430,7 @@ void PlotManager::PrintBufferStatus(bool onlyMissing) const
 //**************************************************************************************************
 bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
 {
+  Profiler::Scope profileScope("GeneratePlot", plot.GetUniqueName());
   bool isInteractiveMode = (mode == "show");
   bool isMacroMode = (mode == "macro");
 
@@ -742,27 +1443,31 @@ bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
     ERROR("No group was specified for plot {}.", plot.GetName());
     return false;
   }
-  Plot fullPlot = plot;
-  if (plot.GetBasePlotName()) {
-    const string& basePlotName = *plot.GetBasePlotName();
-    auto iterator = std::find_if(
-      mBasePlots.begin(), mBasePlots.end(),
-      [&](Plot& basePlot) { return basePlot.GetName() == basePlotName; });
-    if (iterator != mBasePlots.end()) {
-      fullPlot = *iterator + plot;
-    } else {
-      WARNING("Could not find base plot named {}.", basePlotName);
-    }
-  }
+  Plot fullPlot = GetFullPlot(plot);
   if (mode == "print") {
     INFO("Settings of plot {}{}{} from group {}{}{}:", logger::begin_color(logger::Color::Green), fullPlot.GetName(), logger::end_color(), logger::begin_color(logger::Color::Yellow), fullPlot.GetGroup(), logger::end_color());
     Plot::Print(fullPlot.GetPropertyTree(), "");
     return true;
   }
 
+  // the painter may modify the plot, so the state of the definition needs to be determined beforehand
+  string buildHash = (mIncrementalBuild) ? GetBuildHash(fullPlot) : "";
+
+  std::lock_guard<std::mutex> paintLock(gPaintMutex);
+
   PlotPainter painter;
+  if (isInteractiveMode || isMacroMode) InitApplication();
   gROOT->SetBatch(!isInteractiveMode && !isMacroMode);
-  shared_ptr<TCanvas> canvas{painter.GeneratePlot(fullPlot, mDataBuffer)};
+
+  // in batch mode canvases that are only saved to disk are recycled instead of creating a new one for each plot
+  bool recycleCanvas = gROOT->IsBatch() && (mode != "file") && (mode != "data");
+  std::pair<int32_t, int32_t> canvasSize{fullPlot.GetWidth().value_or(gStyle->GetCanvasDefW()), fullPlot.GetHeight().value_or(gStyle->GetCanvasDefH())};
+  unique_ptr<TCanvas> recycledCanvas;
+  if (auto pooledCanvas = mCanvasPool.find(canvasSize); recycleCanvas && pooledCanvas != mCanvasPool.end()) {
+    recycledCanvas = std::move(pooledCanvas->second);
+    mCanvasPool.erase(pooledCanvas);
+  }
+  unique_ptr<TCanvas> canvas{painter.GeneratePlot(fullPlot, mDataBuffer, std::move(recycledCanvas))};
   if (!canvas) return false;
 
   if (TColor::GetFreeColorIndex() > std::numeric_limits<int16_t>::max()) {
@@ -774,10 +1479,16 @@ bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
 
   // if interactive mode is specified, open window instead of saving the plot
   if (isInteractiveMode) {
-    if (auto rc = dynamic_cast<TRootCanvas*>(canvas->GetCanvasImp())) {
+    shared_ptr<TCanvas> shownCanvas{std::move(canvas)};
+    if (auto rc = dynamic_cast<TRootCanvas*>(shownCanvas->GetCanvasImp())) {
       rc->Connect("CloseWindow()", "TApplication", gApplication, "Terminate()");
     }
-    mCanvasRegistry[plot.GetUniqueName()] = canvas;
+    mCanvasRegistry[plot.GetUniqueName()] = shownCanvas;
+    if (mIsWatching) {
+      // all windows stay open and their events are processed while waiting for changes in WatchPlots
+      shownCanvas->Show();
+      return true;
+    }
     mPlotViewHistory.push_back(&plot.GetUniqueName());
     uint32_t curPlotIndex{static_cast<uint32_t>(mPlotViewHistory.size() - 1)};
 
@@ -787,29 +1498,29 @@ bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
     if (curPlotIndex > 0) {
       curXpos = mCanvasRegistry[*mPlotViewHistory[curPlotIndex - 1]]->GetWindowTopX();
       curYpos = mCanvasRegistry[*mPlotViewHistory[curPlotIndex - 1]]->GetWindowTopY();
-      canvas->SetWindowPosition(curXpos, curYpos - mWindowOffsetY);
+      shownCanvas->SetWindowPosition(curXpos, curYpos - mWindowOffsetY);
       static_cast<TRootCanvas*>(mCanvasRegistry[*mPlotViewHistory[curPlotIndex - 1]]->GetCanvasImp())->UnmapWindow();
     }
-    canvas->Show();
+    shownCanvas->Show();
     bool boxClicked = false;
     while (!gSystem->ProcessEvents() && gROOT->GetSelectedPad()) {
-      bool isClick = canvas->GetEvent() == kButton1Double;
-      bool isValidKey = canvas->GetEvent() == kKeyPress && (canvas->GetEventX() == 'a' || canvas->GetEventX() == 's');
-      if (canvas->GetEvent() == kKeyPress && (canvas->GetEventX() == 'q')) {
+      bool isClick = shownCanvas->GetEvent() == kButton1Double;
+      bool isValidKey = shownCanvas->GetEvent() == kKeyPress && (shownCanvas->GetEventX() == 'a' || shownCanvas->GetEventX() == 's');
+      if (shownCanvas->GetEvent() == kKeyPress && (shownCanvas->GetEventX() == 'q')) {
         gApplication->Terminate();
       }
-      auto selectedBox = dynamic_cast<TPave*>(canvas->GetSelected());
+      auto selectedBox = dynamic_cast<TPave*>(shownCanvas->GetSelected());
       if (isClick && selectedBox) {
         if (!boxClicked) INFO("Current position of {}: ({:.3g}, {:.3g}).", selectedBox->GetName(), selectedBox->GetX1NDC(), selectedBox->GetY2NDC());
         boxClicked = true;
       } else if (isClick || isValidKey) {
-        curXpos = canvas->GetWindowTopX();
-        curYpos = canvas->GetWindowTopY();
+        curXpos = shownCanvas->GetWindowTopX();
+        curYpos = shownCanvas->GetWindowTopY();
         bool forward = false;
         if (isValidKey) {
-          forward = (canvas->GetEventX() == 's');
+          forward = (shownCanvas->GetEventX() == 's');
         } else {
-          forward = ((double_t)canvas->GetEventX() / (double_t)canvas->GetWw() > 0.5);
+          forward = ((double_t)shownCanvas->GetEventX() / (double_t)shownCanvas->GetWw() > 0.5);
         }
         if (forward) {
           if (curPlotIndex == mPlotViewHistory.size() - 1) break;
@@ -818,10 +1529,10 @@ bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
           if (curPlotIndex == 0) std::exit(EXIT_SUCCESS);
           --curPlotIndex;
         }
-        static_cast<TRootCanvas*>(canvas->GetCanvasImp())->UnmapWindow();
-        canvas = mCanvasRegistry[*mPlotViewHistory[curPlotIndex]];
-        canvas->SetWindowPosition(curXpos, curYpos - mWindowOffsetY);
-        canvas->Show();
+        static_cast<TRootCanvas*>(shownCanvas->GetCanvasImp())->UnmapWindow();
+        shownCanvas = mCanvasRegistry[*mPlotViewHistory[curPlotIndex]];
+        shownCanvas->SetWindowPosition(curXpos, curYpos - mWindowOffsetY);
+        shownCanvas->Show();
       } else {
         boxClicked = false;
       }
@@ -830,6 +1541,22 @@ bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
     return true;
   }
 
+  // plots rendered to memory are printed while still holding the paint lock, since other managers may modify gStyle or gPad in between
+  if (mode == "buffer") {
+    if (mDecimateVectorMarkers && ((mRenderFormat == "pdf") || (mRenderFormat == "svg") || (mRenderFormat == "eps") || (mRenderFormat == "ps"))) {
+      painter.DecimateOverlappingMarkers(canvas.get());
+    }
+    mRenderedBuffer = PrintToBuffer(canvas.get(), mRenderFormat);
+    // reset TCandle range options to their default values after drawing data
+    TCandle::SetBoxRange(0.5);
+    TCandle::SetWhiskerRange(0.75);
+    if (recycleCanvas) {
+      canvas->Clear();
+      mCanvasPool[canvasSize] = std::move(canvas);
+    }
+    return mRenderedBuffer.has_value();
+  }
+
   if (mOutputDirectory.empty()) {
     ERROR("No output directory was specified. Cannot save plot.");
     return false;
@@ -841,7 +1568,7 @@ bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
   }
 
   if (mode == "file") {
-    mCanvasRegistry[plot.GetUniqueName()] = canvas;
+    mCanvasRegistry[plot.GetUniqueName()] = std::move(canvas);
     return true;
   }
   if (mode == "data") {
@@ -879,7 +1606,7 @@ bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
       }
     };
     cleanNames(canvas.get());
-  } else if ((mode == "pdf") || (mode == "png") || (mode == "eps") || (mode == "svg") || (mode == "ps") || (mode == "html") || (mode == "json") || (mode == "xml") || (mode == "jpg") || (mode == "root")) {
+  } else if (std::find(mFileFormats.begin(), mFileFormats.end(), mode) != mFileFormats.end()) {
     fileEnding = "." + mode;
   } else if (str_contains(mode, "gif")) {
     fileEnding = ".gif";
@@ -894,13 +1621,9 @@ bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
     return false;
   }
 
-  string fileName = plot.GetName();
-  std::replace(fileName.begin(), fileName.end(), ':', '_');
-  std::replace(fileName.begin(), fileName.end(), '/', '_');
-
   // create output folders and files
   string folderName = mOutputDirectory + "/" + plot.GetGroup();
-  string fullName = folderName + "/" + fileName + fileEnding;
+  string fullName = GetOutputFilePath(plot, fileEnding);
 
   if (isGif) {
     if (gifName.empty()) {
@@ -915,66 +1638,372 @@ bool PlotManager::GeneratePlot(const Plot& plot, const string& mode)
     }
   }
   std::filesystem::create_directories(folderName);
-  canvas->SaveAs(fullName.data());
+  if (mDecimateVectorMarkers && ((mode == "pdf") || (mode == "svg") || (mode == "eps") || (mode == "ps"))) {
+    painter.DecimateOverlappingMarkers(canvas.get());
+  }
+  {
+    Profiler::Scope saveScope("SaveAs", fullName);
+    canvas->SaveAs(fullName.data());
+  }
   // reset TCandle range options to their default values after drawing data
   TCandle::SetBoxRange(0.5);
   TCandle::SetWhiskerRange(0.75);
+  if (recycleCanvas) {
+    canvas->Clear();
+    mCanvasPool[canvasSize] = std::move(canvas);
+  }
+  if (mIncrementalBuild && !isGif && !isMacroMode) {
+    WriteManifest(fullName, buildHash);
+  }
   return true;
 }
 
 //**************************************************************************************************
 /**
- * Show which plots are currently loaded in the framework.
+ * Generates a single plot and returns its content in the specified format (png, jpg, svg, pdf, eps, ps or json) without writing it to disk.
+ * Data that were already loaded for previous plots are re-used. Returns an empty string if the plot could not be generated.
  */
 //**************************************************************************************************
-void PlotManager::ListPlots() const
+string PlotManager::RenderToBuffer(const string& name, const string& group, const string& format)
 {
-  for (const auto& plot : mPlots) {
-    INFO(" - {}{}{} in group {}{}{}", logger::begin_color(logger::Color::Green), plot.GetName(), logger::end_color(), logger::begin_color(logger::Color::Yellow), plot.GetGroup(), logger::end_color());
-  }
+  const vector<string> formats{"png", "jpg", "svg", "pdf", "eps", "ps", "json"};
+  if (std::find(formats.begin(), formats.end(), format) == formats.end()) {
+    ERROR("Cannot render plots as {}.", format);
+    return {};
+  }
+  auto plot = std::find_if(mPlots.begin(), mPlots.end(), [&](const Plot& plot) { return plot.GetName() == name && plot.GetGroup() == group; });
+  if (plot == mPlots.end()) {
+    ERROR("Plot {} from group {} is not defined.", name, group);
+    return {};
+  }
+  mRenderFormat = format;
+  mRenderedBuffer.reset();
+  GenerateSelectedPlots({&(*plot)}, "buffer");
+  return mRenderedBuffer.value_or("");
 }
 
 //**************************************************************************************************
 /**
- * Recursively reads data from folder / list and adds it to output data array. Found dataNames are removed from the vectors.
+ * Prints the canvas in the specified format to an in-memory file and returns its content.
+ * Must be called while holding the paint lock.
  */
 //**************************************************************************************************
-void PlotManager::ReadData(TObject* folder, vector<string>& dataNames, const string& prefix, const string& suffix, const string& dataSource)
+optional<string> PlotManager::PrintToBuffer(TCanvas* canvas, const string& format) const
 {
-  TCollection* itemList = nullptr;
-  if (folder->InheritsFrom(TDirectory::Class())) {
-    itemList = static_cast<TDirectoryFile*>(folder)->GetListOfKeys();
-  } else if (folder->InheritsFrom(TFolder::Class())) {
-    itemList = static_cast<TFolder*>(folder)->GetListOfFolders();
-  } else if (folder->InheritsFrom(TCollection::Class())) {
-    itemList = static_cast<TCollection*>(folder);
+  Profiler::Scope profileScope("RenderToBuffer", canvas->GetName());
+  // a temporary file is used where in-memory files are not available
+  string path = (std::filesystem::temp_directory_path() / fmt::format("SciRooPlot_{}.{}", gSystem->GetPid(), format)).string();
+  int32_t fileDescriptor = -1;
+#ifdef SCIROOPLOT_HAVE_MEMFD_CREATE
+  // anonymous file that only lives in memory and is not inherited by child processes
+  fileDescriptor = memfd_create("SciRooPlot", MFD_CLOEXEC);
+  if (fileDescriptor >= 0) path = fmt::format("/proc/self/fd/{}", fileDescriptor);
+#endif
+  canvas->Print(path.data(), format.data());
+  string buffer;
+  {
+    std::ifstream file(path, std::ios::binary);
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+  if (fileDescriptor >= 0) {
+    close(fileDescriptor);
   } else {
-    ERROR("Data format {} not supported.", folder->ClassName());
-    return;
+    std::filesystem::remove(path);
   }
-  itemList->SetOwner();
-
-  // first match should always be the one in current level; traverse deeper only if not found
-  for (bool traverse : {false, true}) {
-    TIter iterator = itemList->begin();
-    TObject* obj{};
-    bool deleteObject;
-    bool removeFromList;
+  if (buffer.empty()) {
+    ERROR("Cannot render plot {} in format {}.", canvas->GetName(), format);
+    return std::nullopt;
+  }
+  return buffer;
+}
 
-    while (iterator != itemList->end()) {
+//**************************************************************************************************
+/**
+ * Returns plot including all properties inherited from its base plot.
+ */
+//**************************************************************************************************
+Plot PlotManager::GetFullPlot(const Plot& plot) const
+{
+  if (plot.GetBasePlotName()) {
+    const string& basePlotName = *plot.GetBasePlotName();
+    auto iterator = std::find_if(
+      mBasePlots.begin(), mBasePlots.end(),
+      [&](const Plot& basePlot) { return basePlot.GetName() == basePlotName; });
+    if (iterator != mBasePlots.end()) {
+      return *iterator + plot;
+    }
+    WARNING("Could not find base plot named {}.", basePlotName);
+  }
+  return plot;
+}
+
+//**************************************************************************************************
+/**
+ * Returns the path of the output file for the plot.
+ */
+//**************************************************************************************************
+string PlotManager::GetOutputFilePath(const Plot& plot, const string& fileEnding) const
+{
+  string fileName = plot.GetName();
+  std::replace(fileName.begin(), fileName.end(), ':', '_');
+  std::replace(fileName.begin(), fileName.end(), '/', '_');
+  return mOutputDirectory + "/" + plot.GetGroup() + "/" + fileName + fileEnding;
+}
+
+//**************************************************************************************************
+/**
+ * Returns a string that changes whenever the input file is modified.
+ */
+//**************************************************************************************************
+string PlotManager::GetFileFingerprint(const string& fileName) const
+{
+  std::error_code sizeError;
+  std::error_code timeError;
+  auto fileSize = std::filesystem::file_size(fileName, sizeError);
+  auto writeTime = std::filesystem::last_write_time(fileName, timeError);
+  if (sizeError || timeError) return fileName + ";missing";
+  return fileName + ";" + std::to_string(fileSize) + ";" + std::to_string(writeTime.time_since_epoch().count());
+}
+
+//**************************************************************************************************
+/**
+ * Returns the fingerprints of all keys in a root file (or its specified sub-directory) by their path.
+ * These are based on the key meta-data (cycle, date, size and position in file) and change with every modification
+ * of the corresponding object. Only the lists of keys are read from the file, but none of the actual objects.
+ */
+//**************************************************************************************************
+const map<string, string>& PlotManager::GetKeyFingerprints(const string& inputFileName) const
+{
+  auto fileNamePath = split_string(inputFileName, ':');
+  const string& fileName = fileNamePath[0];
+
+  // re-use fingerprints as long as file was not modified
+  auto& [fileFingerprint, keyFingerprints] = mKeyFingerprintCache[inputFileName];
+  string curFileFingerprint = GetFileFingerprint(fileName);
+  if (fileFingerprint == curFileFingerprint) return keyFingerprints;
+  fileFingerprint = curFileFingerprint;
+  keyFingerprints.clear();
+
+  if (!std::filesystem::exists(fileName)) return keyFingerprints;
+  TFile inputFile(fileName.data(), "READ");
+  if (inputFile.IsZombie()) return keyFingerprints;
+  TDirectory* topDir = (fileNamePath.size() > 1) ? inputFile.GetDirectory(fileNamePath[1].data()) : &inputFile;
+  if (!topDir) {
+    // entry point is no directory, so the whole file has to be considered
+    keyFingerprints[""] = fileFingerprint;
+    return keyFingerprints;
+  }
+
+  std::function<void(TDirectory*, const string&)> collectKeys;
+  collectKeys = [&](TDirectory* dir, const string& prefix) {
+    for (auto obj : *dir->GetListOfKeys()) {
+      auto key = static_cast<TKey*>(obj);
+      string path = prefix + key->GetName();
+      bool isNew = keyFingerprints.find(path) == keyFingerprints.end();
+      // all cycles of a key contribute
+      keyFingerprints[path] += "{" + std::to_string(key->GetCycle()) + "," + std::to_string(key->GetDatime().Get()) + "," + std::to_string(key->GetNbytes()) + "," + std::to_string(key->GetSeekKey()) + "}";
+      if (isNew && str_contains(key->GetClassName(), "TDirectory")) {
+        if (TDirectory* subDir = dir->GetDirectory(key->GetName())) {
+          collectKeys(subDir, path + "/");
+        }
+      }
+    }
+  };
+  collectKeys(topDir, "");
+  return keyFingerprints;
+}
+
+//**************************************************************************************************
+/**
+ * Returns names of all objects contained in the root files of a dataSource according to the data index.
+ */
+//**************************************************************************************************
+set<string> PlotManager::GetIndexedData(DataIndex& dataIndex, const string& dataSource) const
+{
+  set<string> dataNames;
+  auto inputFiles = mInputFiles.find(dataSource);
+  if (inputFiles == mInputFiles.end()) return dataNames;
+  for (const auto& inputFileName : inputFiles->second) {
+    if (!str_contains(inputFileName, ".root", true)) continue;
+    // names are relative to the entry point of the file
+    auto fileNamePath = split_string(inputFileName, ':');
+    string prefix = (fileNamePath.size() > 1) ? fileNamePath[1] + "/" : "";
+    for (const auto& entry : dataIndex.GetEntries(std::filesystem::absolute(fileNamePath[0]).string())) {
+      if (entry.path.compare(0, prefix.size(), prefix) != 0 || DataIndex::IsFolder(entry.className)) continue;
+      dataNames.insert(entry.path.substr(prefix.size()));
+    }
+  }
+  return dataNames;
+}
+
+//**************************************************************************************************
+/**
+ * Returns names of all data required by the plot grouped by their dataSource.
+ */
+//**************************************************************************************************
+map<string, set<string>> PlotManager::GetRequiredData(Plot& fullPlot) const
+{
+  map<string, set<string>> requiredData;
+  for (auto& [padID, pad] : fullPlot.GetPads()) {
+    if (auto& refFunc = pad.GetRefFunc()) requiredData[refFunc->GetDataSource()].insert(refFunc->GetName());
+    for (const auto& data : pad.GetData()) {
+      requiredData[data->GetDataSource()].insert(data->GetName());
+      if (data->GetType() == "ratio") {
+        const auto& ratio = std::dynamic_pointer_cast<Plot::Pad::Ratio>(data);
+        requiredData[ratio->GetDenomDataSource()].insert(ratio->GetDenomName());
+      }
+    }
+  }
+  return requiredData;
+}
+
+//**************************************************************************************************
+/**
+ * Returns hash of the fully resolved plot definition and the state of all its input files.
+ */
+//**************************************************************************************************
+string PlotManager::GetBuildHash(Plot& fullPlot) const
+{
+  // the plot definition contains names and data info (projections, binning, filters) of all its data
+  std::ostringstream plotDefinition;
+  boost::property_tree::write_info(plotDefinition, fullPlot.GetPropertyTree());
+  string fingerprint = plotDefinition.str();
+
+  for (const auto& [dataSource, dataNames] : GetRequiredData(fullPlot)) {
+    auto inputFiles = mInputFiles.find(dataSource);
+    if (inputFiles == mInputFiles.end()) continue;
+    for (const auto& inputFileName : inputFiles->second) {
+      if (!str_contains(inputFileName, ".root", true)) {
+        fingerprint += "\n" + GetFileFingerprint(inputFileName);
+        continue;
+      }
+      // for root files only the keys of the required objects are relevant
+      const auto& keyFingerprints = GetKeyFingerprints(inputFileName);
+      fingerprint += "\n" + inputFileName;
+      for (const auto& dataName : dataNames) {
+        // objects stored inside other objects (e.g. lists or folders) change together with the key of their container
+        string keyPath = dataName;
+        auto key = keyFingerprints.find(keyPath);
+        while (key == keyFingerprints.end() && keyPath.find('/') != string::npos) {
+          keyPath.erase(keyPath.find_last_of('/'));
+          key = keyFingerprints.find(keyPath);
+        }
+        // keys of directories do not change with their contents, so data that are not found in their own key
+        // (e.g. when found anywhere in the file by traversing it) depend on the whole file
+        bool isDirectory = false;
+        if (key != keyFingerprints.end() && keyPath != dataName) {
+          auto subKey = keyFingerprints.lower_bound(keyPath + "/");
+          isDirectory = subKey != keyFingerprints.end() && subKey->first.compare(0, keyPath.size() + 1, keyPath + "/") == 0;
+        }
+        if (key == keyFingerprints.end() || isDirectory) {
+          fingerprint += ";" + GetFileFingerprint(split_string(inputFileName, ':')[0]);
+        } else {
+          fingerprint += ";" + key->first + key->second;
+        }
+      }
+    }
+  }
+  return std::to_string(hash_string(fingerprint));
+}
+
+//**************************************************************************************************
+/**
+ * Checks if output file exists and was generated from the current plot definition and input files.
+ */
+//**************************************************************************************************
+bool PlotManager::IsUpToDate(Plot& fullPlot, const string& outputFile) const
+{
+  if (!std::filesystem::exists(outputFile)) return false;
+  // in-memory tables can change without notice
+  for (const auto& [dataSource, dataNames] : GetRequiredData(fullPlot)) {
+    if (mTables.find(dataSource) != mTables.end()) return false;
+  }
+  std::filesystem::path outputPath(outputFile);
+  string manifestFile = (outputPath.parent_path() / ("." + outputPath.filename().string() + ".manifest")).string();
+  ptree manifest;
+  try {
+    boost::property_tree::read_info(manifestFile, manifest);
+  } catch (...) {
+    return false;
+  }
+  return manifest.get<string>("hash", "") == GetBuildHash(fullPlot);
+}
+
+//**************************************************************************************************
+/**
+ * Stores the hash the output file was generated with in a (hidden) manifest file next to it.
+ */
+//**************************************************************************************************
+void PlotManager::WriteManifest(const string& outputFile, const string& buildHash) const
+{
+  std::filesystem::path outputPath(outputFile);
+  string manifestFile = (outputPath.parent_path() / ("." + outputPath.filename().string() + ".manifest")).string();
+  ptree manifest;
+  manifest.put("hash", buildHash);
+  try {
+    boost::property_tree::write_info(manifestFile, manifest);
+  } catch (...) {
+    WARNING("Could not write manifest file {}.", manifestFile);
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Show which plots are currently loaded in the framework.
+ */
+//**************************************************************************************************
+void PlotManager::ListPlots() const
+{
+  for (const auto& plot : mPlots) {
+    INFO(" - {}{}{} in group {}{}{}", logger::begin_color(logger::Color::Green), plot.GetName(), logger::end_color(), logger::begin_color(logger::Color::Yellow), plot.GetGroup(), logger::end_color());
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Recursively reads data from folder / list and adds it to output data array. Found dataNames are removed from the vectors.
+ */
+//**************************************************************************************************
+void PlotManager::ReadData(TObject* folder, vector<string>& dataNames, const string& prefix, const string& suffix, const string& dataSource, load_stats_t& stats, const string& keyPath, bool isNested)
+{
+  TCollection* itemList = nullptr;
+  if (folder->InheritsFrom(TDirectory::Class())) {
+    itemList = static_cast<TDirectoryFile*>(folder)->GetListOfKeys();
+  } else if (folder->InheritsFrom(TFolder::Class())) {
+    itemList = static_cast<TFolder*>(folder)->GetListOfFolders();
+  } else if (folder->InheritsFrom(TCollection::Class())) {
+    itemList = static_cast<TCollection*>(folder);
+  } else {
+    ERROR("Data format {} not supported.", folder->ClassName());
+    return;
+  }
+  itemList->SetOwner();
+
+  // first match should always be the one in current level; traverse deeper only if not found
+  for (bool traverse : {false, true}) {
+    TIter iterator = itemList->begin();
+    TObject* obj{};
+    bool deleteObject;
+    bool removeFromList;
+
+    while (iterator != itemList->end()) {
       obj = *iterator;
       deleteObject = true;
       removeFromList = true;
 
-      string curDataName;  // name of current key or data
+      string curDataName;           // name of current key or data
+      string curKeyPath = keyPath;  // objects inside lists or folders are stored in the key of their container
       // read actual object to memory when traversing a directory
       if (obj->IsA() == TKey::Class()) {
+        ++stats.keysScanned;
         string className = static_cast<TKey*>(obj)->GetClassName();
         curDataName = obj->GetName();
+        curKeyPath = (keyPath.empty() ? "" : keyPath + "/") + curDataName;
 
         bool isTraversable = str_contains(className, "TDirectory") || str_contains(className, "TFolder") || str_contains(className, "TList") || str_contains(className, "THashList") || str_contains(className, "TObjArray");
         if ((traverse && isTraversable) || std::find(dataNames.begin(), dataNames.end(), curDataName) != dataNames.end()) {
           obj = static_cast<TKey*>(obj)->ReadObj();
+          ++stats.objectsRead;
           removeFromList = false;
         } else {
           ++iterator;
@@ -985,7 +2014,7 @@ void PlotManager::ReadData(TObject* folder, vector<string>& dataNames, const str
       // in case this object is directory or list, repeat the same for this substructure
       if (obj->InheritsFrom(TDirectory::Class()) || obj->InheritsFrom(TFolder::Class()) || obj->InheritsFrom(TCollection::Class())) {
         if (traverse) {
-          ReadData(obj, dataNames, prefix, suffix, dataSource);
+          ReadData(obj, dataNames, prefix, suffix, dataSource, stats, curKeyPath, true);
         } else if (removeFromList) {
           removeFromList = false;
           deleteObject = false;
@@ -999,25 +2028,16 @@ void PlotManager::ReadData(TObject* folder, vector<string>& dataNames, const str
           if (obj->InheritsFrom(TGraph2D::Class())) static_cast<TGraph2D*>(obj)->SetDirectory(0);
           itemList->Remove(obj);
           dataNames.erase(it);
+          if (traverse || isNested) ++stats.deepLookups;
           string fullName = prefix + curDataName;
+          mDataKeys[dataSource][fullName] = curKeyPath;
           if (obj->InheritsFrom(TTree::Class())) {
             TTree* tree = static_cast<TTree*>(obj);
             mDataBuffer[dataSource][fullName].reset(nullptr);
             // do all requested projections of this tree
-            for (auto& dataInfo : mDataInfoBuffer[dataSource][fullName]) {
-              string dataFullName = fullName + dataInfo.GetNameSuffix();
-              try {
-                SUPPRESS_STDERR(true);
-                if (dataInfo.singleProc()) ROOT::DisableImplicitMT();
-                ROOT::RDataFrame df(*tree);
-                obj = ProcessData(df, fullName, dataInfo, dataFullName + suffix);
-                if (!ROOT::IsImplicitMTEnabled()) ROOT::EnableImplicitMT();
-                SUPPRESS_STDERR(false);
-              } catch (const std::runtime_error&) {
-                ERROR("Invalid query for tree.");
-                obj = nullptr;
-              }
-              mDataBuffer[dataSource][dataFullName].reset(obj);
+            {
+              ROOT::RDataFrame df(*tree);
+              ProcessDataFrame(df, fullName, dataSource, suffix);
             }
             tree->SetDirectory(0);
             delete tree;
@@ -1072,22 +2092,29 @@ void PlotManager::ReadTableData(const string& inputFileName, const string& name,
     }
     ++lineCount;
   }
-  for (auto& dataInfo : mDataInfoBuffer[dataSource][name]) {
-    string dataName = name + dataInfo.GetNameSuffix();
-    TObject* obj = nullptr;
-    try {
-      SUPPRESS_STDERR(true);
-      if (dataInfo.singleProc()) ROOT::DisableImplicitMT();
-      ROOT::RDataFrame df = ROOT::RDF::FromCSV(inputFileName, true, delimiter, 50000);
-      obj = ProcessData(df, name, dataInfo, dataName + ":" + dataSource);
-      if (!ROOT::IsImplicitMTEnabled()) ROOT::EnableImplicitMT();
-      SUPPRESS_STDERR(false);
-    } catch (const std::runtime_error& e) {
-      ERROR("Invalid query for table {}.", name);
-      std::cout << e.what() << std::endl;
-      obj = nullptr;
-    }
-    mDataBuffer[dataSource][dataName].reset(obj);
+  try {
+    ROOT::RDataFrame df = ROOT::RDF::FromCSV(inputFileName, true, delimiter, 50000);
+    ProcessDataFrame(df, name, dataSource, ":" + dataSource);
+  } catch (const std::runtime_error& e) {
+    ERROR("Invalid query for table {}.", name);
+    std::cout << e.what() << std::endl;
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Read table data from memory.
+ */
+//**************************************************************************************************
+void PlotManager::ReadMemoryTable(const string& name, const table_t& columns, const string& dataSource)
+{
+  size_t nRows = std::visit([](const auto& values) { return values.size(); }, columns.begin()->second.values);
+  try {
+    ROOT::RDataFrame df(nRows);
+    ProcessDataFrame(df, name, dataSource, ":" + dataSource, &columns);
+  } catch (const std::runtime_error& e) {
+    ERROR("Invalid query for table {}.", name);
+    std::cout << e.what() << std::endl;
   }
 }
 
@@ -1141,12 +2168,789 @@ TObject* PlotManager::FindSubDirectory(TObject* folder, vector<string>& subDirs)
   return FindSubDirectory(subFolder, subDirs);
 }
 
+//**************************************************************************************************
+/**
+ * Computation graph built on top of a dataframe, in which nodes are identified by the chain of operations leading to them.
+ */
+//**************************************************************************************************
+struct PlotManager::DataFrameGraph {
+  explicit DataFrameGraph(ROOT::RDataFrame& df) : root(df) {}
+  ROOT::RDF::RNode root;
+  map<string, ROOT::RDF::RNode> nodes;
+  map<string, ROOT::RDF::RResultPtr<ULong64_t>> counts;
+  map<string, std::pair<ROOT::RDF::RResultPtr<double_t>, ROOT::RDF::RResultPtr<double_t>>> ranges;  // minimum and maximum of a column at a node
+  bool isBookingRanges{false};  // in the first pass only the ranges of the data are booked
+};
+
+//**************************************************************************************************
+/**
+ * Books all requested data of a dataframe in one computation graph, so they are filled in a single event loop
+ * in which common definitions and filters are evaluated only once.
+ * Axis ranges that are derived from the data are booked for all data in a first pass and determined together in a preceding event loop.
+ */
+//**************************************************************************************************
+void PlotManager::ProcessDataFrame(ROOT::RDataFrame& df, const string& dfName, const string& dataSource, const string& suffix, const table_t* columns)
+{
+  Profiler::Scope profileScope("ProcessData", dataSource + ":" + dfName);
+  DataFrameGraph dfGraph(df);
+  // columns of in-memory tables are read in place at the entry number
+  if (columns) {
+    for (const auto& [columnName, column] : *columns) {
+      const string& name = columnName;
+      auto defineColumn = [&](const auto& values) {
+        const auto* data = values.data();
+        dfGraph.root = dfGraph.root.Define(name, [data](ULong64_t entry) { return data[entry]; }, {"rdfentry_"});
+      };
+      try {
+        std::visit(defineColumn, column.values);
+      } catch (const std::runtime_error&) {
+        WARNING("Cannot use column {} of table {}.", columnName, dfName);
+      }
+    }
+  }
+  auto& dataInfos = mDataInfoBuffer[dataSource][dfName];
+  vector<bool> isValid;
+  dfGraph.isBookingRanges = true;
+  for (auto& dataInfo : dataInfos) {
+    string dataName = dfName + dataInfo.GetNameSuffix();
+    bool valid = false;
+    try {
+      SUPPRESS_STDERR(true);
+      valid = static_cast<bool>(ProcessData(dfGraph, dfName, dataInfo, dataName + suffix));
+      SUPPRESS_STDERR(false);
+    } catch (const std::runtime_error&) {
+      SUPPRESS_STDERR(false);
+      ERROR("Invalid query for {}.", dataName);
+    }
+    isValid.push_back(valid);
+  }
+  dfGraph.isBookingRanges = false;
+
+  vector<std::pair<string, std::function<TObject*()>>> results;
+  for (size_t i = 0; i < dataInfos.size(); ++i) {
+    auto& dataInfo = dataInfos[i];
+    string dataName = dfName + dataInfo.GetNameSuffix();
+    std::function<TObject*()> getResult;
+    // errors were already reported in the first pass
+    if (!isValid[i]) {
+      results.emplace_back(dataName, getResult);
+      continue;
+    }
+    try {
+      SUPPRESS_STDERR(true);
+      getResult = ProcessData(dfGraph, dfName, dataInfo, dataName + suffix);
+      SUPPRESS_STDERR(false);
+    } catch (const std::runtime_error&) {
+      SUPPRESS_STDERR(false);
+      ERROR("Invalid query for {}.", dataName);
+    }
+    results.emplace_back(dataName, getResult);
+  }
+  for (auto& [dataName, getResult] : results) {
+    TObject* obj = nullptr;
+    try {
+      SUPPRESS_STDERR(true);
+      if (getResult) obj = getResult();
+      SUPPRESS_STDERR(false);
+    } catch (const std::runtime_error& e) {
+      SUPPRESS_STDERR(false);
+      ERROR("Invalid query for {}.", dataName);
+      std::cout << e.what() << std::endl;
+    }
+    mDataBuffer[dataSource][dataName].reset(obj);
+  }
+}
+
+namespace
+{
+//**************************************************************************************************
+/**
+ * Calls visitor with a default constructed value of the numeric type corresponding to the column type name.
+ * Returns false for unsupported column types.
+ */
+//**************************************************************************************************
+template <typename Visitor>
+bool visit_column_type(const string& columnType, Visitor&& visitor)
+{
+  if (columnType == "double" || columnType == "Double_t") {
+    visitor(Double_t{});
+  } else if (columnType == "float" || columnType == "Float_t") {
+    visitor(Float_t{});
+  } else if (columnType == "int" || columnType == "Int_t") {
+    visitor(Int_t{});
+  } else if (columnType == "unsigned int" || columnType == "UInt_t") {
+    visitor(UInt_t{});
+  } else if (columnType == "short" || columnType == "Short_t") {
+    visitor(Short_t{});
+  } else if (columnType == "unsigned short" || columnType == "UShort_t") {
+    visitor(UShort_t{});
+  } else if (columnType == "long long" || columnType == "Long64_t") {
+    visitor(Long64_t{});
+  } else if (columnType == "unsigned long long" || columnType == "ULong64_t") {
+    visitor(ULong64_t{});
+  } else if (columnType == "bool" || columnType == "Bool_t") {
+    visitor(Bool_t{});
+  } else {
+    return false;
+  }
+  return true;
+}
+
+//**************************************************************************************************
+/**
+ * Dataframe action filling a sparse histogram. Each thread fills its own histogram and these are merged at the end.
+ * The values of each entry hold the coordinates followed by the weight (if used).
+ */
+//**************************************************************************************************
+class SparseHistHelper : public ROOT::Detail::RDF::RActionImpl<SparseHistHelper>
+{
+ public:
+  using Result_t = THnSparseD;
+
+  SparseHistHelper(const THnSparseD& model, bool hasWeights) : mHasWeights(hasWeights), mResult(static_cast<THnSparseD*>(model.Clone()))
+  {
+    uint32_t nSlots = std::max(1u, ROOT::GetThreadPoolSize());
+    for (uint32_t slot = 0; slot < nSlots; ++slot) {
+      mSlotHists.emplace_back(static_cast<THnSparseD*>(model.Clone()));
+    }
+  }
+  SparseHistHelper(SparseHistHelper&&) = default;
+  SparseHistHelper(const SparseHistHelper&) = delete;
+
+  std::shared_ptr<THnSparseD> GetResultPtr() const { return mResult; }
+  void Initialize() {}
+  void InitTask(TTreeReader*, uint32_t) {}
+  void Exec(uint32_t slot, const ROOT::VecOps::RVec<double_t>& values)
+  {
+    if (mHasWeights) {
+      mSlotHists[slot]->Fill(values.data(), values.back());
+    } else {
+      mSlotHists[slot]->Fill(values.data());
+    }
+  }
+  void Finalize()
+  {
+    for (const auto& slotHist : mSlotHists) {
+      mResult->Add(slotHist.get());
+    }
+  }
+  std::string GetActionName() { return "SparseHisto"; }
+
+ private:
+  bool mHasWeights;
+  std::shared_ptr<THnSparseD> mResult;
+  vector<unique_ptr<THnSparseD>> mSlotHists;
+};
+
+//**************************************************************************************************
+/**
+ * Dataframe action filling a one-dimensional histogram or profile with bins derived from the data in the same event loop.
+ * Each thread fills fine bins of width 2^n on a grid that is aligned for all threads. Whenever the filled range exceeds
+ * the maximum number of fine bins, neighbouring bins are joined, so no entry is ever lost to under- or overflow.
+ * After merging the threads, the fine bins are combined to the requested binning. The values of each entry hold x (y) and the weight (if used).
+ * For logarithmic binning the fine bins are filled with log10(x). Entries that cannot be binned are kept in the under- and overflow
+ * (non-positive x for logarithmic binning and x = -inf in the underflow, other non-finite values in the overflow).
+ */
+//**************************************************************************************************
+template <typename Hist>
+class AdaptiveHistHelper : public ROOT::Detail::RDF::RActionImpl<AdaptiveHistHelper<Hist>>
+{
+ public:
+  using Result_t = Hist;
+  using binning_t = Plot::Pad::Data::binning_t;
+
+  AdaptiveHistHelper(const string& title, binning_t binning, int32_t nBins, bool hasWeights) : mTitle(title), mBinning(binning), mNBins(nBins), mHasWeights(hasWeights), mResult(std::make_shared<Hist>())
+  {
+    mSlotHists.resize(std::max(1u, ROOT::GetThreadPoolSize()));
+  }
+  AdaptiveHistHelper(AdaptiveHistHelper&&) = default;
+  AdaptiveHistHelper(const AdaptiveHistHelper&) = delete;
+
+  std::shared_ptr<Hist> GetResultPtr() const { return mResult; }
+  void Initialize() {}
+  void InitTask(TTreeReader*, uint32_t) {}
+  void Exec(uint32_t slot, const ROOT::VecOps::RVec<double_t>& values)
+  {
+    auto& fineHist = mSlotHists[slot];
+    double_t x = values[0];
+    double_t y = std::is_same_v<Hist, TProfile> ? values[1] : 0.;
+    double_t weight = mHasWeights ? values.back() : 1.;
+    if (mBinning == binning_t::logarithmic) {
+      x = (x > 0.) ? std::log10(x) : -std::numeric_limits<double_t>::infinity();
+    }
+    if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(weight)) {
+      if (std::isinf(x) && x < 0.) {
+        fineHist.underflow.Add(y, weight);
+      } else {
+        fineHist.overflow.Add(y, weight);
+      }
+      ++fineHist.flowEntries;
+      return;
+    }
+    Fill(fineHist, x, y, weight);
+  }
+  void Finalize()
+  {
+    bool addDirStatus = TH1::AddDirectoryStatus();
+    TH1::AddDirectory(false);
+    CombineBins();
+    TH1::AddDirectory(addDirStatus);
+  }
+  std::string GetActionName() { return "AdaptiveHisto"; }
+
+ private:
+  struct fine_bin_t {
+    double_t sumW{};
+    double_t sumW2{};
+    double_t sumWY{};
+    double_t sumWY2{};
+
+    void Add(double_t y, double_t weight)
+    {
+      sumW += weight;
+      sumW2 += weight * weight;
+      sumWY += weight * y;
+      sumWY2 += weight * y * y;
+    }
+    void Add(const fine_bin_t& other)
+    {
+      sumW += other.sumW;
+      sumW2 += other.sumW2;
+      sumWY += other.sumWY;
+      sumWY2 += other.sumWY2;
+    }
+  };
+  struct fine_hist_t {
+    int32_t exponent{};  // fine bins have a width of 2^exponent and bin i covers [i, i+1) * 2^exponent
+    int64_t minIndex{};
+    int64_t maxIndex{};
+    int64_t entries{};
+    std::unordered_map<int64_t, fine_bin_t> bins;
+    fine_bin_t underflow;
+    fine_bin_t overflow;
+    int64_t flowEntries{};
+  };
+
+  // sets the sums of a bin of the histogram or profile
+  static void SetBin(Hist& hist, int32_t bin, const fine_bin_t& content)
+  {
+    if constexpr (std::is_same_v<Hist, TProfile>) {
+      hist.GetW()[bin] = content.sumWY;
+      hist.GetW2()[bin] = content.sumWY2;
+      hist.GetB()[bin] = content.sumW;
+      if (auto* sumW2 = hist.GetB2()) sumW2[bin] = content.sumW2;
+    } else {
+      hist.SetBinContent(bin, content.sumW);
+      if (hist.GetSumw2N()) hist.SetBinError(bin, std::sqrt(content.sumW2));
+    }
+  }
+
+  static int64_t floor_half(int64_t index) { return (index < 0) ? (index - 1) / 2 : index / 2; }
+
+  // doubles the width of the fine bins
+  static void Coarsen(fine_hist_t& fineHist)
+  {
+    std::unordered_map<int64_t, fine_bin_t> bins;
+    for (const auto& [index, bin] : fineHist.bins) {
+      bins[floor_half(index)].Add(bin);
+    }
+    fineHist.bins = std::move(bins);
+    fineHist.minIndex = floor_half(fineHist.minIndex);
+    fineHist.maxIndex = floor_half(fineHist.maxIndex);
+    ++fineHist.exponent;
+  }
+
+  void Fill(fine_hist_t& fineHist, double_t x, double_t y, double_t weight) const
+  {
+    bool isFirst = fineHist.bins.empty();
+    if (isFirst) {
+      // start with a resolution well below the magnitude of the first value
+      fineHist.exponent = (x == 0.) ? -30 : std::ilogb(x) - 20;
+    }
+    // keep the bin indices exactly representable
+    while (std::abs(std::ldexp(x, -fineHist.exponent)) > 1e15) Coarsen(fineHist);
+    auto index = static_cast<int64_t>(std::floor(std::ldexp(x, -fineHist.exponent)));
+    fineHist.minIndex = isFirst ? index : std::min(fineHist.minIndex, index);
+    fineHist.maxIndex = isFirst ? index : std::max(fineHist.maxIndex, index);
+    while (fineHist.maxIndex - fineHist.minIndex >= mNFineBins) {
+      Coarsen(fineHist);
+      index = floor_half(index);
+    }
+    fineHist.bins[index].Add(y, weight);
+    ++fineHist.entries;
+  }
+
+  // merges the fine bins of all threads and converts them to a histogram covering exactly the filled range
+  unique_ptr<Hist> MergeSlots()
+  {
+    fine_hist_t* merged = nullptr;
+    for (auto& slotHist : mSlotHists) {
+      if (slotHist.bins.empty()) continue;
+      if (!merged) {
+        merged = &slotHist;
+        continue;
+      }
+      while (merged->exponent < slotHist.exponent) Coarsen(*merged);
+      while (slotHist.exponent < merged->exponent) Coarsen(slotHist);
+      for (const auto& [index, bin] : slotHist.bins) {
+        merged->bins[index].Add(bin);
+      }
+      merged->minIndex = std::min(merged->minIndex, slotHist.minIndex);
+      merged->maxIndex = std::max(merged->maxIndex, slotHist.maxIndex);
+      merged->entries += slotHist.entries;
+      while (merged->maxIndex - merged->minIndex >= mNFineBins) Coarsen(*merged);
+    }
+    if (!merged) return nullptr;
+
+    double_t width = std::ldexp(1., merged->exponent);
+    auto nFineBins = static_cast<int32_t>(merged->maxIndex - merged->minIndex + 1);
+    auto fineHist = std::make_unique<Hist>("fine", "", nFineBins, merged->minIndex * width, (merged->maxIndex + 1) * width);
+    if (mHasWeights) fineHist->Sumw2();
+    for (const auto& [index, bin] : merged->bins) {
+      SetBin(*fineHist, static_cast<int32_t>(index - merged->minIndex + 1), bin);
+    }
+    fineHist->ResetStats();
+    fineHist->SetEntries(static_cast<double_t>(merged->entries));
+    return fineHist;
+  }
+
+  // adds the entries that could not be binned to the under- and overflow of the final histogram
+  void SetFlowBins(Hist& hist) const
+  {
+    fine_bin_t underflow;
+    fine_bin_t overflow;
+    int64_t flowEntries{};
+    for (const auto& slotHist : mSlotHists) {
+      underflow.Add(slotHist.underflow);
+      overflow.Add(slotHist.overflow);
+      flowEntries += slotHist.flowEntries;
+    }
+    if (!flowEntries) return;
+    double_t entries = hist.GetEntries();
+    SetBin(hist, 0, underflow);
+    SetBin(hist, hist.GetNbinsX() + 1, overflow);
+    hist.SetEntries(entries + static_cast<double_t>(flowEntries));
+  }
+
+  void CombineBins()
+  {
+    auto fineHist = MergeSlots();
+    if (!fineHist) {
+      Hist hist(mResult->GetName(), mTitle.data(), mNBins, 0., 1.);
+      if (mHasWeights) hist.Sumw2();
+      SetFlowBins(hist);
+      hist.Copy(*mResult);
+      return;
+    }
+
+    // content of the fine bins that is distributed to the final bins
+    auto binWeight = [&](int32_t bin) {
+      if constexpr (std::is_same_v<Hist, TProfile>) {
+        return fineHist->GetBinEntries(bin);
+      } else {
+        return fineHist->GetBinContent(bin);
+      }
+    };
+    int32_t nFineBins = fineHist->GetNbinsX();
+    int32_t firstBin = 1;
+    int32_t lastBin = nFineBins;
+    while (firstBin < lastBin && !binWeight(firstBin)) ++firstBin;
+    while (lastBin > firstBin && !binWeight(lastBin)) --lastBin;
+
+    // the final bin edges are a subset of the fine ones, such that no entries need to be re-distributed
+    vector<int32_t> edgeBins;
+    auto groupBins = [&](int32_t nGroup) {
+      int32_t nGroups = (lastBin - firstBin + nGroup) / nGroup;
+      int32_t startBin = std::max(1, std::min(firstBin, nFineBins + 1 - nGroups * nGroup));
+      for (int32_t group = 0; group <= nGroups; ++group) {
+        int32_t edgeBin = std::min(startBin + group * nGroup, nFineBins + 1);
+        if (edgeBins.empty() || edgeBin > edgeBins.back()) edgeBins.push_back(edgeBin);
+      }
+    };
+    vector<double_t> cumulative{0.};
+    for (int32_t bin = firstBin; bin <= lastBin; ++bin) {
+      cumulative.push_back(cumulative.back() + binWeight(bin));
+    }
+    auto quantileBin = [&](double_t fraction) {
+      auto pos = std::lower_bound(cumulative.begin() + 1, cumulative.end(), fraction * cumulative.back());
+      return firstBin + static_cast<int32_t>(pos - cumulative.begin());
+    };
+
+    if (mBinning == binning_t::quantile) {
+      edgeBins.push_back(firstBin);
+      for (int32_t bin = 1; bin < mNBins; ++bin) {
+        int32_t edgeBin = quantileBin(static_cast<double_t>(bin) / mNBins);
+        if (edgeBin > edgeBins.back() && edgeBin <= lastBin) edgeBins.push_back(edgeBin);
+      }
+      edgeBins.push_back(lastBin + 1);
+    } else if (mBinning == binning_t::freedman_diaconis) {
+      double_t fineWidth = fineHist->GetXaxis()->GetBinWidth(1);
+      double_t iqr = (quantileBin(0.75) - quantileBin(0.25)) * fineWidth;
+      double_t width = 2. * iqr / std::cbrt(fineHist->GetEntries());
+      int32_t nFilledBins = lastBin + 1 - firstBin;
+      int32_t nGroup = std::max(1, static_cast<int32_t>(std::round(width / fineWidth)));
+      string variable = mTitle.substr(1, mTitle.find(';', 1) - 1);
+      if (iqr <= 0.) {
+        // most entries have the same value, so the bins would shrink to the fine bins
+        WARNING("Interquartile range of {} is zero. Using {} equal bins instead of the Freedman-Diaconis rule.", variable, mNBins);
+        nGroup = (nFilledBins + mNBins - 1) / mNBins;
+      } else if (nFilledBins > nGroup * mMaxBins) {
+        WARNING("Freedman-Diaconis rule yields more than {} bins for {}. Using {} bins.", mMaxBins, variable, mMaxBins);
+        nGroup = (nFilledBins + mMaxBins - 1) / mMaxBins;
+      }
+      groupBins(nGroup);
+    } else {
+      // equal bins (up to the fine bin width) keeping the requested number of bins
+      edgeBins.push_back(firstBin);
+      for (int32_t bin = 1; bin <= mNBins; ++bin) {
+        int32_t edgeBin = firstBin + static_cast<int32_t>(std::round(static_cast<double_t>(bin) * (lastBin + 1 - firstBin) / mNBins));
+        if (edgeBin > edgeBins.back()) edgeBins.push_back(edgeBin);
+      }
+    }
+
+    vector<double_t> edges;
+    for (auto edgeBin : edgeBins) {
+      edges.push_back(fineHist->GetXaxis()->GetBinLowEdge(edgeBin));
+    }
+    unique_ptr<Hist> hist(static_cast<Hist*>(fineHist->Rebin(static_cast<int32_t>(edges.size()) - 1, mResult->GetName(), edges.data())));
+    if (mBinning == binning_t::logarithmic) {
+      for (auto& edge : edges) {
+        edge = std::pow(10., edge);
+      }
+      hist->GetXaxis()->Set(static_cast<int32_t>(edges.size()) - 1, edges.data());
+    }
+    hist->SetTitle(mTitle.data());
+    SetFlowBins(*hist);
+    hist->Copy(*mResult);
+  }
+
+  const int32_t mNFineBins{10000};
+  const int32_t mMaxBins{1000};  // upper limit for the number of bins derived via the Freedman-Diaconis rule
+  string mTitle;
+  binning_t mBinning;
+  int32_t mNBins;
+  bool mHasWeights;
+  std::shared_ptr<Hist> mResult;
+  vector<fine_hist_t> mSlotHists;
+};
+
+//**************************************************************************************************
+/**
+ * Arithmetic expression of numeric columns and constants that is evaluated natively instead of being just-in-time compiled.
+ * Supported are parentheses, the operators + - * / % ! && || and comparisons. All values are evaluated as double, so only columns whose
+ * integer arithmetic is exactly represented (up to int) may be used. As in C++, division and modulo of integers truncate.
+ */
+//**************************************************************************************************
+class NativeExpression
+{
+ public:
+  enum class value_t { floating, integer, boolean };
+  using column_type_t = std::function<optional<value_t>(const string&)>;
+
+  static constexpr size_t mMaxColumns{8};
+
+  static shared_ptr<const NativeExpression> Parse(const string& expression, const column_type_t& getColumnType);
+
+  const vector<string>& GetColumns() const { return mColumns; }
+  value_t GetType() const { return mNodes.back().type; }
+  double_t Evaluate(const double_t* columnValues) const { return Evaluate(columnValues, static_cast<int32_t>(mNodes.size()) - 1); }
+
+ private:
+  enum class op_t { constant, column, negate, logicalNot, add, subtract, multiply, divide, modulo, less, lessEqual, greater, greaterEqual, equal, notEqual, logicalAnd, logicalOr };
+  struct node_t {
+    op_t op;
+    value_t type;
+    double_t value{};  // value of constants or index of columns
+    int32_t lhs{-1};
+    int32_t rhs{-1};
+  };
+
+  double_t Evaluate(const double_t* columnValues, int32_t index) const;
+
+  // recursive descent parser, each step returns the index of the created node or -1 for unsupported syntax
+  int32_t ParseLogicalOr();
+  int32_t ParseLogicalAnd();
+  int32_t ParseComparison();
+  int32_t ParseSum();
+  int32_t ParseProduct();
+  int32_t ParseUnary();
+  int32_t ParsePrimary();
+  int32_t AddNode(op_t op, int32_t lhs, int32_t rhs = -1);
+  bool Consume(const string& token);
+
+  vector<node_t> mNodes;  // children are stored before their parents, so the last node is the root
+  vector<string> mColumns;
+  string mText;  // only used while parsing
+  size_t mPos{};
+  const column_type_t* mGetColumnType{};
+};
+
+shared_ptr<const NativeExpression> NativeExpression::Parse(const string& expression, const column_type_t& getColumnType)
+{
+  auto nativeExpression = std::make_shared<NativeExpression>();
+  nativeExpression->mText = expression;
+  nativeExpression->mGetColumnType = &getColumnType;
+  int32_t root = nativeExpression->ParseLogicalOr();
+  nativeExpression->Consume("");  // skips trailing whitespace
+  if (root < 0 || nativeExpression->mPos != expression.size()) return nullptr;
+  if (nativeExpression->mColumns.empty() || nativeExpression->mColumns.size() > mMaxColumns) return nullptr;
+  nativeExpression->mText.clear();
+  nativeExpression->mGetColumnType = nullptr;
+  return nativeExpression;
+}
+
+bool NativeExpression::Consume(const string& token)
+{
+  while (mPos < mText.size() && std::isspace(static_cast<unsigned char>(mText[mPos]))) ++mPos;
+  if (mText.compare(mPos, token.size(), token) != 0) return false;
+  mPos += token.size();
+  return true;
+}
+
+int32_t NativeExpression::AddNode(op_t op, int32_t lhs, int32_t rhs)
+{
+  if (lhs < 0 || (rhs < 0 && op != op_t::negate && op != op_t::logicalNot)) return -1;
+  value_t type = value_t::boolean;
+  if (op == op_t::negate || op == op_t::add || op == op_t::subtract || op == op_t::multiply || op == op_t::divide || op == op_t::modulo) {
+    bool isFloating = (mNodes[lhs].type == value_t::floating) || (rhs >= 0 && mNodes[rhs].type == value_t::floating);
+    // the remainder is only defined for integers
+    if (isFloating && op == op_t::modulo) return -1;
+    type = isFloating ? value_t::floating : value_t::integer;
+  }
+  mNodes.push_back({op, type, 0., lhs, rhs});
+  return static_cast<int32_t>(mNodes.size()) - 1;
+}
+
+int32_t NativeExpression::ParseLogicalOr()
+{
+  int32_t lhs = ParseLogicalAnd();
+  while (lhs >= 0 && Consume("||")) {
+    lhs = AddNode(op_t::logicalOr, lhs, ParseLogicalAnd());
+  }
+  return lhs;
+}
+
+int32_t NativeExpression::ParseLogicalAnd()
+{
+  int32_t lhs = ParseComparison();
+  while (lhs >= 0 && Consume("&&")) {
+    lhs = AddNode(op_t::logicalAnd, lhs, ParseComparison());
+  }
+  return lhs;
+}
+
+int32_t NativeExpression::ParseComparison()
+{
+  // chained comparisons are left to the interpreter
+  int32_t lhs = ParseSum();
+  if (lhs < 0) return lhs;
+  for (const auto& [token, op] : vector<std::pair<string, op_t>>{{"<=", op_t::lessEqual}, {">=", op_t::greaterEqual}, {"==", op_t::equal}, {"!=", op_t::notEqual}, {"<", op_t::less}, {">", op_t::greater}}) {
+    if (Consume(token)) return AddNode(op, lhs, ParseSum());
+  }
+  return lhs;
+}
+
+int32_t NativeExpression::ParseSum()
+{
+  int32_t lhs = ParseProduct();
+  while (lhs >= 0) {
+    if (Consume("+")) {
+      lhs = AddNode(op_t::add, lhs, ParseProduct());
+    } else if (Consume("-")) {
+      lhs = AddNode(op_t::subtract, lhs, ParseProduct());
+    } else {
+      break;
+    }
+  }
+  return lhs;
+}
+
+int32_t NativeExpression::ParseProduct()
+{
+  int32_t lhs = ParseUnary();
+  while (lhs >= 0) {
+    if (Consume("*")) {
+      lhs = AddNode(op_t::multiply, lhs, ParseUnary());
+    } else if (Consume("/")) {
+      lhs = AddNode(op_t::divide, lhs, ParseUnary());
+    } else if (Consume("%")) {
+      lhs = AddNode(op_t::modulo, lhs, ParseUnary());
+    } else {
+      break;
+    }
+  }
+  return lhs;
+}
+
+int32_t NativeExpression::ParseUnary()
+{
+  if (Consume("-")) return AddNode(op_t::negate, ParseUnary());
+  if (Consume("!")) return AddNode(op_t::logicalNot, ParseUnary());
+  if (Consume("+")) return ParseUnary();
+  return ParsePrimary();
+}
+
+int32_t NativeExpression::ParsePrimary()
+{
+  if (Consume("(")) {
+    int32_t inner = ParseLogicalOr();
+    return (inner >= 0 && Consume(")")) ? inner : -1;
+  }
+  if (mPos >= mText.size()) return -1;
+  auto isNameChar = [](char character) { return std::isalnum(static_cast<unsigned char>(character)) || character == '_'; };
+  char first = mText[mPos];
+  if (std::isdigit(static_cast<unsigned char>(first)) || first == '.') {
+    const char* begin = mText.data() + mPos;
+    char* end = nullptr;
+    double_t value = std::strtod(begin, &end);
+    string literal(begin, end);
+    mPos += literal.size();
+    // hexadecimal numbers and literals with suffixes (e.g. 1.f or 2u) are left to the interpreter
+    if (literal.empty() || literal.find_first_of("xX") != string::npos || (mPos < mText.size() && isNameChar(mText[mPos]))) return -1;
+    bool isInteger = (literal.find_first_of(".eE") == string::npos);
+    // integers that are not exactly representable as double are left to the interpreter
+    if (isInteger && value > 9007199254740992.) return -1;
+    mNodes.push_back({op_t::constant, isInteger ? value_t::integer : value_t::floating, value});
+    return static_cast<int32_t>(mNodes.size()) - 1;
+  }
+  if (!isNameChar(first)) return -1;
+  size_t end = mPos;
+  while (end < mText.size() && isNameChar(mText[end])) ++end;
+  string name = mText.substr(mPos, end - mPos);
+  mPos = end;
+  if (name == "true" || name == "false") {
+    mNodes.push_back({op_t::constant, value_t::boolean, (name == "true") ? 1. : 0.});
+    return static_cast<int32_t>(mNodes.size()) - 1;
+  }
+  // anything that is not a numeric column (e.g. functions or constants) has to be compiled
+  auto type = (*mGetColumnType)(name);
+  if (!type) return -1;
+  auto column = std::find(mColumns.begin(), mColumns.end(), name);
+  if (column == mColumns.end()) column = mColumns.insert(mColumns.end(), name);
+  mNodes.push_back({op_t::column, *type, static_cast<double_t>(column - mColumns.begin())});
+  return static_cast<int32_t>(mNodes.size()) - 1;
+}
+
+double_t NativeExpression::Evaluate(const double_t* columnValues, int32_t index) const
+{
+  const node_t& node = mNodes[index];
+  switch (node.op) {
+    case op_t::constant:
+      return node.value;
+    case op_t::column:
+      return columnValues[static_cast<size_t>(node.value)];
+    case op_t::negate:
+      return -Evaluate(columnValues, node.lhs);
+    case op_t::logicalNot:
+      return !Evaluate(columnValues, node.lhs);
+    case op_t::logicalAnd:
+      return Evaluate(columnValues, node.lhs) && Evaluate(columnValues, node.rhs);
+    case op_t::logicalOr:
+      return Evaluate(columnValues, node.lhs) || Evaluate(columnValues, node.rhs);
+    default:
+      break;
+  }
+  double_t lhs = Evaluate(columnValues, node.lhs);
+  double_t rhs = Evaluate(columnValues, node.rhs);
+  switch (node.op) {
+    case op_t::add:
+      return lhs + rhs;
+    case op_t::subtract:
+      return lhs - rhs;
+    case op_t::multiply:
+      return lhs * rhs;
+    case op_t::divide:
+      return (node.type == value_t::integer) ? std::trunc(lhs / rhs) : lhs / rhs;
+    case op_t::modulo:
+      return std::fmod(lhs, rhs);
+    case op_t::less:
+      return lhs < rhs;
+    case op_t::lessEqual:
+      return lhs <= rhs;
+    case op_t::greater:
+      return lhs > rhs;
+    case op_t::greaterEqual:
+      return lhs >= rhs;
+    case op_t::equal:
+      return lhs == rhs;
+    default:
+      return lhs != rhs;
+  }
+}
+
+template <size_t>
+using column_value_t = Double_t;
+
+//**************************************************************************************************
+/**
+ * Wraps a native expression in a function taking the (double) values of its columns as individual arguments, as required by the dataframe.
+ */
+//**************************************************************************************************
+template <typename R, size_t... I>
+auto make_native_function(shared_ptr<const NativeExpression> expression, std::index_sequence<I...>)
+{
+  return [expression](column_value_t<I>... values) {
+    const double_t columnValues[]{values...};
+    return static_cast<R>(expression->Evaluate(columnValues));
+  };
+}
+
+//**************************************************************************************************
+/**
+ * Calls visitor with the index sequence corresponding to the number of columns. Returns false if there are too many columns.
+ */
+//**************************************************************************************************
+template <size_t N = 1, typename Visitor>
+bool visit_arity(size_t nColumns, Visitor&& visitor)
+{
+  if (nColumns == N) {
+    visitor(std::make_index_sequence<N>{});
+    return true;
+  }
+  if constexpr (N < NativeExpression::mMaxColumns) {
+    return visit_arity<N + 1>(nColumns, std::forward<Visitor>(visitor));
+  }
+  return false;
+}
+
+//**************************************************************************************************
+/**
+ * Defines a column from a native expression of the specified columns (which must be of type double).
+ * The type of the new column follows the expression (double, long long or bool).
+ */
+//**************************************************************************************************
+ROOT::RDF::RNode define_native(ROOT::RDF::RNode node, const string& colName, const shared_ptr<const NativeExpression>& expression, const vector<string>& columns)
+{
+  visit_arity(columns.size(), [&](auto indices) {
+    if (expression->GetType() == NativeExpression::value_t::boolean) {
+      node = node.Define(colName, make_native_function<Bool_t>(expression, indices), columns);
+    } else if (expression->GetType() == NativeExpression::value_t::integer) {
+      node = node.Define(colName, make_native_function<Long64_t>(expression, indices), columns);
+    } else {
+      node = node.Define(colName, make_native_function<Double_t>(expression, indices), columns);
+    }
+  });
+  return node;
+}
+
+//**************************************************************************************************
+/**
+ * Adds filter from a native expression of the specified columns (which must be of type double).
+ */
+//**************************************************************************************************
+ROOT::RDF::RNode filter_native(ROOT::RDF::RNode node, const shared_ptr<const NativeExpression>& expression, const vector<string>& columns)
+{
+  visit_arity(columns.size(), [&](auto indices) { node = node.Filter(make_native_function<bool>(expression, indices), columns); });
+  return node;
+}
+}  // namespace
+
 //**************************************************************************************************
 /**
  * Process RDataFrame according to the settings stored in dataInfo.
  */
 //**************************************************************************************************
-TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, const Plot::Pad::Data::data_info_t& dataInfo, const string& name) const
+std::function<TObject*()> PlotManager::ProcessData(DataFrameGraph& dfGraph, const string& dfName, const Plot::Pad::Data::data_info_t& dataInfo, const string& name) const
 {
   bool isProfile = false;
   bool isScatter = false;
@@ -1160,7 +2964,7 @@ TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, co
   auto dataDims = dataInfo.dataDims;  // make copy here so it can be modified
   if (isProfile && dataDims.size() > 3) {
     ERROR("Too many dimensions specified for profile of {}.", dfName);
-    return nullptr;
+    return {};
   }
   int32_t axisID = 1;
   for (auto& dataDim : dataDims) {
@@ -1168,74 +2972,179 @@ TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, co
       // sanity check for binned axes
       if ((dataDim.nBins && dataDim.edges.size() != 2) || (!dataDim.nBins && dataDim.edges.size() <= 1)) {
         ERROR("Can't project tree {} due to ill defined binning for {}.", dfName, dataDim.var);
-        return nullptr;
+        return {};
       }
       if (!std::is_sorted(dataDim.edges.begin(), dataDim.edges.end())) {
         if (!(dataDim.edges.size() == 2 && !dataDim.edges[0] && !dataDim.edges[1])) {
           ERROR("Can't project tree {} due to ill defined binning for {}.", dfName, dataDim.var);
-          return nullptr;
+          return {};
         }
       }
     }
     ++axisID;
   }
 
-  TObject* obj = nullptr;
-  ROOT::RDF::RNode node = df;  // working node
+  ROOT::RDF::RNode node = dfGraph.root;  // working node
+  string nodeKey;                        // canonical chain of operations leading to the working node
+
+  // operations that were already applied in the same order for other data of the dataframe are re-used,
+  // so common definitions and filters are evaluated only once per entry
+  auto extendNode = [&](const string& operation, const std::function<ROOT::RDF::RNode()>& addOperation) {
+    nodeKey += operation + ";";
+    if (auto cachedNode = dfGraph.nodes.find(nodeKey); cachedNode != dfGraph.nodes.end()) {
+      node = cachedNode->second;
+    } else {
+      node = addOperation();
+      dfGraph.nodes.emplace(nodeKey, node);
+    }
+  };
+  auto countEntries = [&]() {
+    auto count = dfGraph.counts.find(nodeKey);
+    if (count == dfGraph.counts.end()) count = dfGraph.counts.emplace(nodeKey, node.Count()).first;
+    return count->second;
+  };
+  // expressions are compared without the whitespace outside of string literals
+  auto canonical = [](const string& expression) {
+    string canonicalExpression;
+    char quote{};
+    for (char character : expression) {
+      if (quote) {
+        if (character == quote) quote = 0;
+      } else if (character == '"' || character == '\'') {
+        quote = character;
+      } else if (std::isspace(static_cast<unsigned char>(character))) {
+        continue;
+      }
+      canonicalExpression += character;
+    }
+    return canonicalExpression;
+  };
+
+  // expressions that are plain column names or simple arithmetic of numeric columns are handled natively
+  // since just-in-time compiling each of them is expensive for many projections
+  auto isColumn = [&](const string& expression) {
+    auto columnNames = node.GetColumnNames();
+    return std::find(columnNames.begin(), columnNames.end(), expression) != columnNames.end();
+  };
+  auto getNativeType = [&](const string& column) -> optional<NativeExpression::value_t> {
+    optional<NativeExpression::value_t> type;
+    if (!isColumn(column)) return type;
+    visit_column_type(node.GetColumnType(column), [&](auto x) {
+      using T = decltype(x);
+      if constexpr (std::is_same_v<T, Bool_t>) {
+        type = NativeExpression::value_t::boolean;
+      } else if constexpr (std::is_integral_v<T>) {
+        // integers are evaluated as double, which is only exact for types promoted to int (unsigned and 64 bit arithmetic is left to the interpreter)
+        if constexpr (sizeof(T) < sizeof(Int_t) || (std::is_signed_v<T> && sizeof(T) == sizeof(Int_t))) type = NativeExpression::value_t::integer;
+      } else {
+        type = NativeExpression::value_t::floating;
+      }
+    });
+    return type;
+  };
+  // numeric columns of other types are converted to double in a separate column (with a reserved name that cannot clash with the input columns)
+  auto getDoubleColumn = [&](const string& column) -> optional<string> {
+    string valueColumn = column;
+    bool isNumeric = visit_column_type(node.GetColumnType(column), [&](auto x) {
+      using T = decltype(x);
+      if constexpr (!std::is_same_v<T, Double_t>) {
+        valueColumn = fmt::format("SRP_DOUBLE_{:x}", hash_string(column));
+        if (!isColumn(valueColumn)) {
+          extendNode("D:" + valueColumn, [&]() { return node.Define(valueColumn, [](T value) { return static_cast<Double_t>(value); }, {column}); });
+        }
+      }
+    });
+    if (!isNumeric) return {};
+    return valueColumn;
+  };
+  auto getDoubleColumns = [&](const NativeExpression& expression) {
+    vector<string> valueColumns;
+    for (const auto& column : expression.GetColumns()) {
+      valueColumns.push_back(*getDoubleColumn(column));
+    }
+    return valueColumns;
+  };
+  auto defineColumn = [&](const string& colName, const string& expression) {
+    string operation = "D:" + colName + "=" + canonical(expression);
+    if (isColumn(expression)) {
+      extendNode(operation, [&]() { return node.Alias(colName, expression); });
+    } else if (auto nativeExpression = NativeExpression::Parse(expression, getNativeType)) {
+      auto valueColumns = getDoubleColumns(*nativeExpression);
+      extendNode(operation, [&]() { return define_native(node, colName, nativeExpression, valueColumns); });
+    } else {
+      extendNode(operation, [&]() { return node.Define(colName, expression); });
+    }
+  };
+  auto addFilter = [&](const string& expression) {
+    string operation = "F:" + canonical(expression);
+    if (auto nativeExpression = NativeExpression::Parse(expression, getNativeType)) {
+      auto valueColumns = getDoubleColumns(*nativeExpression);
+      extendNode(operation, [&]() { return filter_native(node, nativeExpression, valueColumns); });
+    } else {
+      extendNode(operation, [&]() { return node.Filter(expression); });
+    }
+  };
 
   if (dataInfo.definitions.keys && dataInfo.definitions.values) {
     for (int i = 0; i < dataInfo.definitions.keys->size(); ++i) {
-      node = node.Define(dataInfo.definitions.keys->at(i), dataInfo.definitions.values->at(i));
+      defineColumn(dataInfo.definitions.keys->at(i), dataInfo.definitions.values->at(i));
     }
   }
   if (dataInfo.entries.max) {
-    if (dataInfo.entries.min) {
-      node = node.Range(*dataInfo.entries.min, *dataInfo.entries.max);
-    } else {
-      node = node.Range(*dataInfo.entries.max);
-    }
-  }
-  auto nEntriesPreFilter = node.Count();
+    // in contrast to Range, selecting the entry numbers also works for multi-threaded event loops
+    ULong64_t minEntry = dataInfo.entries.min.value_or(0);
+    ULong64_t maxEntry = *dataInfo.entries.max;
+    extendNode(fmt::format("R:{}:{}", minEntry, maxEntry), [&]() -> ROOT::RDF::RNode {
+      return node.Filter([minEntry, maxEntry](ULong64_t entry) { return entry >= minEntry && entry < maxEntry; }, {"rdfentry_"});
+    });
+  }
+  auto nEntriesPreFilter = countEntries();
+  optional<ROOT::RDF::RResultPtr<ULong64_t>> nEntriesPostFilter;
   if (dataInfo.filters) {
     for (int32_t i = 0; i < dataInfo.filters->size(); ++i) {
       try {
-        node = node.Filter(dataInfo.filters->at(i));
+        addFilter(dataInfo.filters->at(i));
       } catch (std::runtime_error) {
         ERROR("Illegal expression in filter: {}.", dataInfo.filters->at(i));
-        return nullptr;
+        return {};
       }
     }
-    auto nEntriesPostFilter = node.Count();
-    if (nEntriesPostFilter && nEntriesPreFilter) {
-      INFO("Processing {} entries ({:.2f}%) of {}.", (*nEntriesPostFilter), 100. * (*nEntriesPostFilter) / (*nEntriesPreFilter), dfName);
-    }
-  } else {
-    if (nEntriesPreFilter) {
-      INFO("Processing {} entries of {}.", *nEntriesPreFilter, dfName);
-    }
+    nEntriesPostFilter = countEntries();
   }
 
   string histTitle;
+  vector<string> axisColumns;
+  vector<tuple<Plot::Pad::Data::data_dim_t*, ROOT::RDF::RResultPtr<double_t>, ROOT::RDF::RResultPtr<double_t>>> autoRanges;
+  bool isAdaptive = false;
   axisID = 1;
   for (auto& dataDim : dataDims) {
-    string colName = "SRP_AXIS_" + std::to_string(axisID);
+    // columns are named after their expression so they can be shared with other data
+    string colName = fmt::format("SRP_AXIS_{:x}", hash_string(canonical(dataDim.var)));
+    axisColumns.push_back(colName);
     try {
-      node = node.Define(colName, dataDim.var);
+      if (!isColumn(colName)) defineColumn(colName, dataDim.var);
     } catch (std::runtime_error) {
       ERROR("Illegal expression: {}.", dataDim.var);
-      return nullptr;
+      return {};
     }
     if (node.GetColumnType(colName).find("string") != string::npos) {
       ERROR("Variable expression {} is not numeric.", dataDim.var);
-      return nullptr;
+      return {};
     }
-    if (dataDim.nBins && dataDim.edges.size() == 2 && !dataDim.edges[0] && !dataDim.edges[1]) {
-      // auto-detect bin edges given the data
-      auto max = node.Max("SRP_AXIS_" + std::to_string(axisID));
-      auto min = node.Min("SRP_AXIS_" + std::to_string(axisID));
-      double_t margin = 0.01;
-      dataDim.edges[0] = (*min) * ((*min) > 0 ? (1. - margin) : (1. + margin));
-      dataDim.edges[1] = (*max) * ((*max) > 0 ? (1. + margin) : (1. - margin));
+    bool isBinned = (isProjection || (isProfile && axisID < dataDims.size()));
+    if (isBinned && dataDim.nBins && dataDim.edges.size() == 2 && !dataDim.edges[0] && !dataDim.edges[1]) {
+      // one-dimensional histograms and profiles derive non-uniform bins from the data while being filled
+      if (dataDim.binning != Plot::Pad::Data::uniform && axisID == 1 && dataDims.size() == (isProfile ? 2 : 1)) {
+        isAdaptive = true;
+      } else {
+        if (dataDim.binning != Plot::Pad::Data::uniform && dfGraph.isBookingRanges) {
+          WARNING("Binning mode for {} is only available for one-dimensional histograms and profiles. Using equal bins.", dataDim.var);
+        }
+        // auto-detect bin edges given the data
+        auto range = dfGraph.ranges.find(nodeKey + colName);
+        if (range == dfGraph.ranges.end()) range = dfGraph.ranges.emplace(nodeKey + colName, std::make_pair(node.Min(colName), node.Max(colName))).first;
+        autoRanges.push_back({&dataDim, range->second.first, range->second.second});
+      }
     }
     if (isProfile && axisID == dataDims.size()) {
       histTitle += ";#LT " + dataDim.var + " #GT";
@@ -1244,38 +3153,119 @@ TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, co
     }
     ++axisID;
   }
+  // the data themselves are only booked once the ranges of all data of the dataframe are booked
+  if (dfGraph.isBookingRanges) return []() -> TObject* { return nullptr; };
+  // ranges of all axes of all data are determined in the same event loop
+  for (auto& [dataDim, min, max] : autoRanges) {
+    double_t margin = 0.01;
+    dataDim->edges[0] = (*min) * ((*min) > 0 ? (1. - margin) : (1. + margin));
+    dataDim->edges[1] = (*max) * ((*max) > 0 ? (1. + margin) : (1. - margin));
+  }
+
+  // results are only booked here and retrieved once all data of the dataframe are booked, so they are filled in the same event loop
+  std::function<TObject*()> getResult;
+  auto bookResult = [](auto result) -> std::function<TObject*()> { return [result]() mutable -> TObject* { return result->Clone(); }; };
+  auto finishResult = [&]() -> std::function<TObject*()> {
+    if (!getResult) return {};
+    return [getResult, nEntriesPreFilter, nEntriesPostFilter, dfName, name, histTitle]() mutable -> TObject* {
+      if (nEntriesPostFilter) {
+        INFO("Processing {} entries ({:.2f}%) of {}.", (**nEntriesPostFilter), 100. * (**nEntriesPostFilter) / (*nEntriesPreFilter), dfName);
+      } else {
+        INFO("Processing {} entries of {}.", *nEntriesPreFilter, dfName);
+      }
+      TObject* obj = getResult();
+      if (!obj) return nullptr;
+      static_cast<TNamed*>(obj)->SetName(name.data());
+      if (obj->InheritsFrom(TH1::Class())) static_cast<TH1*>(obj)->SetDirectory(0);
+      if (obj->InheritsFrom(TGraph::Class())) static_cast<TGraph*>(obj)->SetTitle(histTitle.data());
+      return obj;
+    };
+  };
+
   if (isScatter) {
-    if (dataDims.size() == 2) {
-      obj = node.Graph("SRP_AXIS_1", "SRP_AXIS_2")->Clone(name.data());
-    } else if (dataDims.size() == 4) {
-      obj = node.GraphAsymmErrors("SRP_AXIS_1", "SRP_AXIS_2", "SRP_AXIS_3", "SRP_AXIS_3", "SRP_AXIS_4", "SRP_AXIS_4")->Clone(name.data());
-    } else if (dataDims.size() == 6) {
-      obj = node.GraphAsymmErrors("SRP_AXIS_1", "SRP_AXIS_2", "SRP_AXIS_3", "SRP_AXIS_4", "SRP_AXIS_5", "SRP_AXIS_6")->Clone(name.data());
-    } else {
+    if (dataDims.size() != 2 && dataDims.size() != 4 && dataDims.size() != 6) {
       ERROR("Invalid number of columns for scatter data.");
-      return nullptr;
+      return {};
+    }
+    // in multi-threaded event loops the points are collected per slot in arbitrary order,
+    // so they are taken together with their entry numbers and sorted once the loop is finished
+    vector<string> valueColumns;
+    for (const auto& axisColumn : axisColumns) {
+      auto valueColumn = getDoubleColumn(axisColumn);
+      if (!valueColumn) {
+        ERROR("Scatter data can only be created from numeric columns.");
+        return {};
+      }
+      valueColumns.push_back(*valueColumn);
     }
-    if (obj && obj->InheritsFrom(TGraph::Class())) {
-      TGraph* graph = static_cast<TGraph*>(obj);
-      graph->SetTitle(histTitle.data());
-      return graph;
+    auto entries = node.Take<ULong64_t>("rdfentry_");
+    vector<ROOT::RDF::RResultPtr<vector<Double_t>>> values;
+    for (const auto& valueColumn : valueColumns) {
+      values.push_back(node.Take<Double_t>(valueColumn));
     }
+    getResult = [entries, values]() mutable -> TObject* {
+      vector<size_t> order(entries->size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return (*entries)[a] < (*entries)[b]; });
+      vector<vector<Double_t>> points(values.size(), vector<Double_t>(order.size()));
+      for (size_t column = 0; column < values.size(); ++column) {
+        const auto& columnValues = *values[column];
+        for (size_t point = 0; point < order.size(); ++point) {
+          points[column][point] = columnValues[order[point]];
+        }
+      }
+      int32_t nPoints = static_cast<int32_t>(order.size());
+      if (points.size() == 2) return new TGraph(nPoints, points[0].data(), points[1].data());
+      if (points.size() == 4) return new TGraphAsymmErrors(nPoints, points[0].data(), points[1].data(), points[2].data(), points[2].data(), points[3].data(), points[3].data());
+      return new TGraphAsymmErrors(nPoints, points[0].data(), points[1].data(), points[2].data(), points[3].data(), points[4].data(), points[5].data());
+    };
+    return finishResult();
   }
   if (!isProfile) {
     histTitle += (dataInfo.weight) ? ";weighted counts" : ";counts";
   }
 
+  string weightColumn;
   if (dataInfo.weight) {
+    weightColumn = fmt::format("SRP_WEIGHT_{:x}", hash_string(canonical(*dataInfo.weight)));
     try {
-      node = node.Define("SRP_AXIS_W", *dataInfo.weight);
+      if (!isColumn(weightColumn)) defineColumn(weightColumn, *dataInfo.weight);
     } catch (std::runtime_error) {
       ERROR("Illegal expression for weights: {}.", *dataInfo.weight);
-      return nullptr;
+      return {};
     }
     hasWeights = true;
   }
 
-  if (dataDims.size() == 1) {
+  // the coordinates (and weight) of each entry can be passed to custom actions as one vector
+  auto definePointColumn = [&](const vector<string>& colNames) -> optional<string> {
+    string pointExpression;
+    for (const auto& colName : colNames) {
+      pointExpression += (pointExpression.empty() ? "" : ", ") + fmt::format("static_cast<double>({})", colName);
+    }
+    pointExpression = "ROOT::VecOps::RVec<double>{" + pointExpression + "}";
+    string pointColumn = fmt::format("SRP_POINT_{:x}", hash_string(pointExpression));
+    try {
+      if (!isColumn(pointColumn)) defineColumn(pointColumn, pointExpression);
+    } catch (std::runtime_error) {
+      ERROR("Could not combine the columns of {}.", dfName);
+      return {};
+    }
+    return pointColumn;
+  };
+  auto bookAdaptive = [&](auto* histType) {
+    using Hist = std::remove_pointer_t<decltype(histType)>;
+    vector<string> colNames = axisColumns;
+    if (hasWeights) colNames.push_back(weightColumn);
+    auto pointColumn = definePointColumn(colNames);
+    if (!pointColumn) return;
+    const auto& dataDim = dataDims.at(0);
+    getResult = bookResult(node.Book<ROOT::VecOps::RVec<double_t>>(AdaptiveHistHelper<Hist>(histTitle, dataDim.binning, dataDim.nBins, hasWeights), {*pointColumn}));
+  };
+
+  if (dataDims.size() == 1 && isAdaptive) {
+    bookAdaptive(static_cast<TH1D*>(nullptr));
+  } else if (dataDims.size() == 1) {
     auto histModel = ROOT::RDF::TH1DModel();
     auto& dataDim1 = dataDims.at(0);
 
@@ -1285,14 +3275,16 @@ TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, co
       histModel = ROOT::RDF::TH1DModel("tmp", histTitle.data(), dataDim1.nBins, dataDim1.edges[0], dataDim1.edges[1]);
     }
     if (hasWeights) {
-      obj = node.Histo1D(histModel, "SRP_AXIS_1", "SRP_AXIS_W")->Clone(name.data());
+      getResult = bookResult(node.Histo1D(histModel, axisColumns[0], weightColumn));
     } else {
-      obj = node.Histo1D(histModel, "SRP_AXIS_1")->Clone(name.data());
+      getResult = bookResult(node.Histo1D(histModel, axisColumns[0]));
     }
   } else if (dataDims.size() == 2) {
     auto& dataDim1 = dataDims.at(0);
     auto& dataDim2 = dataDims.at(1);
-    if (isProfile) {
+    if (isProfile && isAdaptive) {
+      bookAdaptive(static_cast<TProfile*>(nullptr));
+    } else if (isProfile) {
       auto profileModel = ROOT::RDF::TProfile1DModel();
       if (!dataDim1.nBins) {
         profileModel = ROOT::RDF::TProfile1DModel("tmp", histTitle.data(), static_cast<int32_t>(dataDim1.edges.size()) - 1, dataDim1.edges.data());
@@ -1300,9 +3292,9 @@ TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, co
         profileModel = ROOT::RDF::TProfile1DModel("tmp", histTitle.data(), dataDim1.nBins, dataDim1.edges[0], dataDim1.edges[1]);
       }
       if (hasWeights) {
-        obj = node.Profile1D(profileModel, "SRP_AXIS_1", "SRP_AXIS_2", "SRP_AXIS_W")->Clone(name.data());
+        getResult = bookResult(node.Profile1D(profileModel, axisColumns[0], axisColumns[1], weightColumn));
       } else {
-        obj = node.Profile1D(profileModel, "SRP_AXIS_1", "SRP_AXIS_2")->Clone(name.data());
+        getResult = bookResult(node.Profile1D(profileModel, axisColumns[0], axisColumns[1]));
       }
     } else {
       auto histModel = ROOT::RDF::TH2DModel();
@@ -1316,9 +3308,9 @@ TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, co
         histModel = ROOT::RDF::TH2DModel("tmp", histTitle.data(), static_cast<int32_t>(dataDim1.edges.size()) - 1, dataDim1.edges.data(), dataDim2.nBins, dataDim2.edges[0], dataDim2.edges[1]);
       }
       if (hasWeights) {
-        obj = node.Histo2D(histModel, "SRP_AXIS_1", "SRP_AXIS_2", "SRP_AXIS_W")->Clone(name.data());
+        getResult = bookResult(node.Histo2D(histModel, axisColumns[0], axisColumns[1], weightColumn));
       } else {
-        obj = node.Histo2D(histModel, "SRP_AXIS_1", "SRP_AXIS_2")->Clone(name.data());
+        getResult = bookResult(node.Histo2D(histModel, axisColumns[0], axisColumns[1]));
       }
     }
   } else if (dataDims.size() == 3) {
@@ -1338,9 +3330,9 @@ TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, co
         profileModel = ROOT::RDF::TProfile2DModel("tmp", histTitle.data(), static_cast<int32_t>(dataDim1.edges.size()) - 1, dataDim1.edges.data(), dataDim2.nBins, dataDim2.edges[0], dataDim2.edges[1]);
       }
       if (hasWeights) {
-        obj = node.Profile2D(profileModel, "SRP_AXIS_1", "SRP_AXIS_2", "SRP_AXIS_3", "SRP_AXIS_W")->Clone(name.data());
+        getResult = bookResult(node.Profile2D(profileModel, axisColumns[0], axisColumns[1], axisColumns[2], weightColumn));
       } else {
-        obj = node.Profile2D(profileModel, "SRP_AXIS_1", "SRP_AXIS_2", "SRP_AXIS_3")->Clone(name.data());
+        getResult = bookResult(node.Profile2D(profileModel, axisColumns[0], axisColumns[1], axisColumns[2]));
       }
     } else {
       auto histModel = ROOT::RDF::TH3DModel();
@@ -1362,9 +3354,9 @@ TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, co
         histModel = ROOT::RDF::TH3DModel("tmp", histTitle.data(), static_cast<int32_t>(dataDim1.edges.size()) - 1, dataDim1.edges.data(), static_cast<int32_t>(dataDim2.edges.size()) - 1, dataDim2.edges.data(), static_cast<int32_t>(dataDim3.edges.size()) - 1, dataDim3.edges.data());
       }
       if (hasWeights) {
-        obj = node.Histo3D(histModel, "SRP_AXIS_1", "SRP_AXIS_2", "SRP_AXIS_3", "SRP_AXIS_W")->Clone(name.data());
+        getResult = bookResult(node.Histo3D(histModel, axisColumns[0], axisColumns[1], axisColumns[2], weightColumn));
       } else {
-        obj = node.Histo3D(histModel, "SRP_AXIS_1", "SRP_AXIS_2", "SRP_AXIS_3")->Clone(name.data());
+        getResult = bookResult(node.Histo3D(histModel, axisColumns[0], axisColumns[1], axisColumns[2]));
       }
     }
   } else {
@@ -1405,20 +3397,35 @@ TObject* PlotManager::ProcessData(ROOT::RDataFrame& df, const string& dfName, co
         }
         histModel = ROOT::RDF::THnDModel("tmp", histTitle.data(), static_cast<int32_t>(dataDims.size()), nBinsVec, xBins);
       }
-      vector<string> colNames;
-      axisID = 1;
-      for (auto& dataDim : dataDims) {
-        colNames.push_back("SRP_AXIS_" + std::to_string(axisID));
-        ++axisID;
-      }
+      vector<string> colNames = axisColumns;
       if (hasWeights) {
-        colNames.push_back("SRP_AXIS_W");
+        colNames.push_back(weightColumn);
+      }
+
+      // dense histograms allocate all bins (including under- and overflow) for each thread, so above a threshold only filled bins are stored
+      double_t nDenseBins = 1.;
+      for (auto nBins : nBinsVec) {
+        nDenseBins *= nBins + 2;
+      }
+      if (dataInfo.isSparse.value_or(nDenseBins > mMaxDenseBins)) {
+        THnSparseD sparseModel("tmp", histTitle.data(), static_cast<int32_t>(dataDims.size()), nBinsVec.data());
+        for (int32_t axis = 0; axis < dataDims.size(); ++axis) {
+          const auto& dataDim = dataDims[axis];
+          if (dataDim.nBins) {
+            sparseModel.GetAxis(axis)->Set(dataDim.nBins, dataDim.edges[0], dataDim.edges[1]);
+          } else {
+            sparseModel.GetAxis(axis)->Set(nBinsVec[axis], dataDim.edges.data());
+          }
+        }
+        auto pointColumn = definePointColumn(colNames);
+        if (!pointColumn) return {};
+        getResult = bookResult(node.Book<ROOT::VecOps::RVec<double_t>>(SparseHistHelper(sparseModel, hasWeights), {*pointColumn}));
+      } else {
+        getResult = bookResult(node.HistoND(histModel, colNames));
       }
-      obj = node.HistoND(histModel, colNames)->Clone(name.data());
     }
   }
-  if (obj && obj->InheritsFrom(TH1::Class())) static_cast<TH1*>(obj)->SetDirectory(0);
-  return obj;
+  return finishResult();
 }
 
 //****************************************************************************************
@@ -1643,5 +3650,13 @@ void PlotManager::SaveProject() const
     tabCompFile << line;
   }
   tabCompFile.close();
+
+  // update the index of all input files (only changed files are read), which also provides the tab completion of the object paths
+  DataIndex dataIndex(Config::Get().DataIndexFile(mProjectName));
+  for (const auto& [dataSource, inputFiles] : mInputFiles) {
+    GetIndexedData(dataIndex, dataSource);
+  }
+  dataIndex.Prune();
+  dataIndex.Save();
 }
 }  // end namespace SciRooPlot
@@ -20,6 +20,7 @@
 
 #include "SciRooPlot/Helpers.h"
 #include "SciRooPlot/Logging.h"
+#include "SciRooPlot/Profiler.h"
 
 #include <TApplication.h>
 #include <TCanvas.h>
@@ -65,12 +66,15 @@
 #include <TTimeStamp.h>
 #include <TView.h>
 
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <numeric>
 #include <regex>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 using std::array;
@@ -167,17 +171,29 @@ constexpr bool is_3d()
  * Function to generate the plot.
  */
 //**************************************************************************************************
-unique_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<string, unordered_map<string, unique_ptr<TObject>>>& dataBuffer)
+unique_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<string, unordered_map<string, unique_ptr<TObject>>>& dataBuffer, unique_ptr<TCanvas> canvas_ptr)
 {
+  Profiler::Scope profileScope("PaintPlot");
   bool fail = false;
 
   double_t canvasWidth = plot.GetWidth().value_or(gStyle->GetCanvasDefW());
   double_t canvasHeight = plot.GetHeight().value_or(gStyle->GetCanvasDefH());
-  // generate canvas with 'invisible' dummy size to avoid annoying popup window
-  unique_ptr<TCanvas> canvas_ptr{new TCanvas(plot.GetUniqueName().data(), plot.GetUniqueName().data(), 1., 1.)};
-  if (gROOT->IsBatch()) {
+  if (canvas_ptr && gROOT->IsBatch()) {
+    // re-use (empty) off-screen canvas of a previous plot with the same dimensions and restore its defaults
+    canvas_ptr->SetName(plot.GetUniqueName().data());
+    canvas_ptr->SetTitle(plot.GetUniqueName().data());
+    canvas_ptr->SetFillColor(gStyle->GetCanvasColor());
+    canvas_ptr->SetFillStyle(1001);
+    canvas_ptr->SetFixedAspectRatio(false);
+    if (canvas_ptr->GetWw() != canvasWidth || canvas_ptr->GetWh() != canvasHeight) {
+      canvas_ptr->SetCanvasSize(canvasWidth, canvasHeight);
+    }
+  } else if (gROOT->IsBatch()) {
+    // generate canvas with 'invisible' dummy size to avoid annoying popup window
+    canvas_ptr.reset(new TCanvas(plot.GetUniqueName().data(), plot.GetUniqueName().data(), 1., 1.));
     canvas_ptr->SetCanvasSize(canvasWidth, canvasHeight);
   } else {
+    canvas_ptr.reset(new TCanvas(plot.GetUniqueName().data(), plot.GetUniqueName().data(), 1., 1.));
     auto canvasImp = static_cast<TRootCanvas*>(canvas_ptr->GetCanvasImp());
     canvasImp->UnmapWindow();
     canvas_ptr->SetCanvasSize(canvasWidth, canvasHeight);
@@ -627,31 +643,41 @@ unique_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
                   axis_ptr->SetTicks((*axisLayout.GetTickOrientation()).data());
                 }
 
-                pad_ptr->Update();  // needed here so current user ranges correct
-                double_t xmin = 0, xmax = 0, ymin = 0, ymax = 0, min = 0, max = 0;
-                pad_ptr->GetRangeAxis(xmin, ymin, xmax, ymax);
-                min = axisHist_ptr->GetMinimumStored();
-                max = axisHist_ptr->GetMaximumStored();
-                if (auto view = pad_ptr->GetView()) {
-                  double_t minArr[3];
-                  double_t maxArr[3];
-                  view->GetRange(minArr, maxArr);
-                  xmin = minArr[0];
-                  xmax = maxArr[0];
-                  ymin = minArr[1];
-                  ymax = maxArr[1];
-                  if constexpr (is_hist_3d<data_type>()) {
-                    min = minArr[2];
-                    max = maxArr[2];
+                // current user ranges of the independent axes are defined by the visible bins of the axis histogram
+                TAxis* axisX = axisHist_ptr->GetXaxis();
+                TAxis* axisY = axisHist_ptr->GetYaxis();
+                double_t xmin = axisX->GetBinLowEdge(axisX->GetFirst());
+                double_t xmax = axisX->GetBinUpEdge(axisX->GetLast());
+                double_t ymin = axisY->GetBinLowEdge(axisY->GetFirst());
+                double_t ymax = axisY->GetBinUpEdge(axisY->GetLast());
+                double_t min = axisHist_ptr->GetMinimumStored();
+                double_t max = axisHist_ptr->GetMaximumStored();
+                bool isLogClipped = (pad_ptr->GetLogx() && xmin <= 0.) || (isTHN && pad_ptr->GetLogy() && ymin <= 0.);
+                if (pad_ptr->GetView() || isLogClipped) {
+                  // 3d views and log axes with non-positive lower edge are only known after painting the pad
+                  pad_ptr->Update();
+                  pad_ptr->GetRangeAxis(xmin, ymin, xmax, ymax);
+                  if (auto view = pad_ptr->GetView()) {
+                    double_t minArr[3];
+                    double_t maxArr[3];
+                    view->GetRange(minArr, maxArr);
+                    xmin = minArr[0];
+                    xmax = maxArr[0];
+                    ymin = minArr[1];
+                    ymax = maxArr[1];
+                    if constexpr (is_hist_3d<data_type>()) {
+                      min = minArr[2];
+                      max = maxArr[2];
+                    }
+                  }
+                  if (pad_ptr->GetLogx()) {
+                    xmin = TMath::Power(10, xmin);
+                    xmax = TMath::Power(10, xmax);
+                  }
+                  if (isTHN && pad_ptr->GetLogy()) {
+                    ymin = TMath::Power(10, ymin);
+                    ymax = TMath::Power(10, ymax);
                   }
-                }
-                if (pad_ptr->GetLogx()) {
-                  xmin = TMath::Power(10, xmin);
-                  xmax = TMath::Power(10, xmax);
-                }
-                if (isTHN && pad_ptr->GetLogy()) {
-                  ymin = TMath::Power(10, ymin);
-                  ymax = TMath::Power(10, ymax);
                 }
 
                 double_t curRangeMin = (axisLabel == 'X') ? xmin : ((isTHN && axisLabel == 'Y') ? ymin : min);
@@ -877,6 +903,20 @@ unique_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
             data_ptr->SetRange(rangeMinX, rangeMaxX);
           } else if constexpr (is_graph_1d<data_type>()) {
             SetGraphRange(static_cast<TGraph*>(data_ptr), data->GetMinRangeX(), data->GetMaxRangeX());
+            if (data->GetDecimate() && *data->GetDecimate()) {
+              // only the drawn copy is reduced, while the buffered data stays untouched
+              string upperDrawingOptions = drawingOptions;
+              std::transform(upperDrawingOptions.begin(), upperDrawingOptions.end(), upperDrawingOptions.begin(), ::toupper);
+              bool isPlainGraph = (data_ptr->IsA() == TGraph::Class());
+              bool isBand = (upperDrawingOptions.find_first_of("2345") != string::npos);
+              // error bars are drawn for every single point, so these cannot be reduced
+              bool hasErrorBars = !isPlainGraph && !isBand && (upperDrawingOptions.find('X') == string::npos || upperDrawingOptions.find("[]") != string::npos);
+              if (isBand || (!hasErrorBars && upperDrawingOptions.find_first_of("LCFB") != string::npos)) {
+                DecimateLine(data_ptr, pad_ptr);
+              } else if (!hasErrorBars) {
+                DecimateMarkers(data_ptr, pad_ptr);
+              }
+            }
           } else {
             data_ptr->GetXaxis()->SetRangeUser(rangeMinX, rangeMaxX);
           }
@@ -918,7 +958,6 @@ unique_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
               ERROR("Invalid legend label ({}) specified for data {} in {}.", legendID, data->GetName(), data->GetDataSource());
             }
           }
-          pad_ptr->Update();  // adds something to the list of primitives
         }
         ++dataIndex;
         drawingOptions = "SAME ";  // next data should be drawn to same pad
@@ -941,6 +980,8 @@ unique_ptr<TCanvas> PlotPainter::GeneratePlot(Plot& plot, const unordered_map<st
     if (fail) {
       return nullptr;
     }
+    // paint all data at once (adds e.g. palettes to the list of primitives) instead of after each draw call
+    if (dataIndex > 1) pad_ptr->Update();
 
     bool redrawAxes = (pad.GetRedrawAxes())
                         ? *pad.GetRedrawAxes()
@@ -1082,6 +1123,7 @@ bool PlotPainter::CheckFontSizes(TList* list)
 //**************************************************************************************************
 TPave* PlotPainter::GenerateBox(variant<shared_ptr<Plot::Pad::LegendBox>, shared_ptr<Plot::Pad::TextBox>> boxVariant, TPad* pad)
 {
+  Profiler::Scope profileScope("GenerateBox");
   TPave* returnBox{nullptr};
 
   auto processBox = [&](auto&& box) {
@@ -1460,6 +1502,7 @@ TPave* PlotPainter::GenerateBox(variant<shared_ptr<Plot::Pad::LegendBox>, shared
 //**************************************************************************************************
 optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj, const optional<Plot::Pad::Data::proj_info_t>& projInfo)
 {
+  Profiler::Scope profileScope("GetDataClone", obj ? obj->GetName() : "");
   if (obj) {
     if (projInfo) {
       bool addDirStatus = TH1::AddDirectoryStatus();
@@ -1513,6 +1556,7 @@ optional<data_ptr_t> PlotPainter::GetDataClone(TObject* obj)
 
 optional<data_ptr_t> PlotPainter::GetProjection(TObject* obj, Plot::Pad::Data::proj_info_t projInfo)
 {
+  Profiler::Scope profileScope("GetProjection");
   const bool isProfile = projInfo.isProfile && *projInfo.isProfile;
   // only 1d and 2d histograms are valid outputs! (could be extended to 3d if there is a way to plot this)
   if (projInfo.dims.size() == 0 || projInfo.dims.size() > 2) {
@@ -1839,6 +1883,63 @@ void PlotPainter::Divide(TH1* numerator, TH1* denominator, bool binomialErrors)
         return;
       }
     }
+    // if one binning is an exact coarsening of the other, merge the finer bins instead of interpolating
+    bool isProfile = false;
+    for (TH1* hist : {numerator, denominator}) {
+      if (hist->InheritsFrom(TProfile::Class()) || hist->InheritsFrom(TProfile2D::Class()) || hist->InheritsFrom(TProfile3D::Class())) {
+        isProfile = true;
+      }
+    }
+    if (!isProfile && numerator->GetDimension() == denominator->GetDimension()) {
+      auto getBinMaps = [&](TH1* fineHist, TH1* coarseHist) -> optional<array<vector<int32_t>, 3>> {
+        array<vector<int32_t>, 3> binMaps{vector<int32_t>{0}, vector<int32_t>{0}, vector<int32_t>{0}};
+        for (int16_t i = 0; i < fineHist->GetDimension(); ++i) {
+          auto binMap = GetAlignedBinMap(GetAxis(fineHist, i), GetAxis(coarseHist, i));
+          if (!binMap) return nullopt;
+          binMaps[i] = *binMap;
+        }
+        return binMaps;
+      };
+      if (auto binMaps = getBinMaps(denominator, numerator)) {
+        unique_ptr<TH1> coarseDenominator(static_cast<TH1*>(numerator->Clone("coarseDenominator")));
+        coarseDenominator->SetDirectory(nullptr);
+        FillAlignedRebin(denominator, coarseDenominator.get(), *binMaps);
+        numerator->Divide(numerator, coarseDenominator.get(), 1., 1., (binomialErrors) ? "B" : "");
+        return;
+      }
+      if (auto binMaps = getBinMaps(numerator, denominator)) {
+        unique_ptr<TH1> coarseNumerator(static_cast<TH1*>(denominator->Clone("coarseNumerator")));
+        coarseNumerator->SetDirectory(nullptr);
+        FillAlignedRebin(numerator, coarseNumerator.get(), *binMaps);
+        coarseNumerator->Divide(coarseNumerator.get(), denominator, 1., 1., (binomialErrors) ? "B" : "");
+
+        // numerator takes over the coarse binning of the denominator
+        auto getEdges = [](TAxis* axis) {
+          vector<double_t> edges;
+          for (int32_t i = 1; i <= axis->GetNbins() + 1; ++i) {
+            edges.push_back(axis->GetBinLowEdge(i));
+          }
+          return edges;
+        };
+        auto edgesX = getEdges(denominator->GetXaxis());
+        auto edgesY = getEdges(denominator->GetYaxis());
+        auto edgesZ = getEdges(denominator->GetZaxis());
+        if (numerator->GetDimension() == 1) {
+          numerator->SetBins(edgesX.size() - 1, edgesX.data());
+        } else if (numerator->GetDimension() == 2) {
+          numerator->SetBins(edgesX.size() - 1, edgesX.data(), edgesY.size() - 1, edgesY.data());
+        } else {
+          numerator->SetBins(edgesX.size() - 1, edgesX.data(), edgesY.size() - 1, edgesY.data(), edgesZ.size() - 1, edgesZ.data());
+        }
+        numerator->Reset();
+        for (int32_t i = 0; i < coarseNumerator->GetNcells(); ++i) {
+          numerator->SetBinContent(i, coarseNumerator->GetBinContent(i));
+          numerator->SetBinError(i, coarseNumerator->GetBinError(i));
+        }
+        numerator->SetEntries(coarseNumerator->GetEntries());
+        return;
+      }
+    }
     if (numerator->GetDimension() == 1 && denominator->GetDimension() == 1) {
       TGraphErrors denominatorGraph(denominator);
       Divide(numerator, &denominatorGraph, binomialErrors);
@@ -1892,6 +1993,64 @@ void PlotPainter::Divide(TGraph* numerator, TF1* denominator, bool binomialError
   }
 }
 
+//**************************************************************************************************
+/**
+ * Checks if the bin edges of the coarse axis are a subset of the edges of the fine axis.
+ * Returns for each bin of the fine axis (including under- and overflow) the corresponding bin of the coarse axis.
+ */
+//**************************************************************************************************
+optional<vector<int32_t>> PlotPainter::GetAlignedBinMap(TAxis* fineAxis, TAxis* coarseAxis)
+{
+  const int32_t nFineBins = fineAxis->GetNbins();
+  const int32_t nCoarseBins = coarseAxis->GetNbins();
+  if (nCoarseBins > nFineBins) return nullopt;
+  const double_t tolerance = 1e-9 * (fineAxis->GetXmax() - fineAxis->GetXmin());
+
+  vector<int32_t> binMap(nFineBins + 2);
+  binMap[0] = 0;
+  binMap[nFineBins + 1] = nCoarseBins + 1;
+
+  // walk along both sorted edge lists simultaneously, every coarse edge must be matched by a fine edge
+  int32_t coarseEdge = 1;
+  for (int32_t fineEdge = 1; fineEdge <= nFineBins + 1; ++fineEdge) {
+    double_t fineEdgePos = fineAxis->GetBinLowEdge(fineEdge);
+    if (coarseEdge <= nCoarseBins + 1) {
+      double_t coarseEdgePos = coarseAxis->GetBinLowEdge(coarseEdge);
+      if (coarseEdgePos < fineEdgePos - tolerance) return nullopt;
+      if (std::abs(coarseEdgePos - fineEdgePos) <= tolerance) ++coarseEdge;
+    }
+    if (fineEdge <= nFineBins) binMap[fineEdge] = coarseEdge - 1;
+  }
+  if (coarseEdge <= nCoarseBins + 1) return nullopt;
+  return binMap;
+}
+
+//**************************************************************************************************
+/**
+ * Sums up contents and squared weights of the fine histogram into the bins of the coarse histogram.
+ */
+//**************************************************************************************************
+void PlotPainter::FillAlignedRebin(TH1* fineHist, TH1* coarseHist, const array<vector<int32_t>, 3>& binMaps)
+{
+  coarseHist->Reset();
+  if (!coarseHist->GetSumw2N()) coarseHist->Sumw2();
+  const double_t* fineSumw2 = (fineHist->GetSumw2N()) ? fineHist->GetSumw2()->GetArray() : nullptr;
+  double_t* coarseSumw2 = coarseHist->GetSumw2()->GetArray();
+
+  for (int32_t iz = 0; iz < binMaps[2].size(); ++iz) {
+    for (int32_t iy = 0; iy < binMaps[1].size(); ++iy) {
+      for (int32_t ix = 0; ix < binMaps[0].size(); ++ix) {
+        int32_t fineBin = fineHist->GetBin(ix, iy, iz);
+        int32_t coarseBin = coarseHist->GetBin(binMaps[0][ix], binMaps[1][iy], binMaps[2][iz]);
+        double_t content = fineHist->GetBinContent(fineBin);
+        coarseHist->AddBinContent(coarseBin, content);
+        coarseSumw2[coarseBin] += (fineSumw2) ? fineSumw2[fineBin] : std::abs(content);
+      }
+    }
+  }
+  coarseHist->SetEntries(fineHist->GetEntries());
+}
+
 //**************************************************************************************************
 /**
  * Deletes data points of graph beyond cutoff values.
@@ -1935,6 +2094,125 @@ void PlotPainter::ScaleGraph(TGraph* graph, double_t scale)
   }
 }
 
+//**************************************************************************************************
+/**
+ * Removes the markers of plain graphs in the pad (and its sub-pads) that would be painted
+ * onto exactly the same pixel as a previous marker. Vector formats otherwise contain each of them.
+ */
+//**************************************************************************************************
+void PlotPainter::DecimateOverlappingMarkers(TPad* pad)
+{
+  TIter next(pad->GetListOfPrimitives());
+  TObject* obj = nullptr;
+  while ((obj = next())) {
+    if (obj->InheritsFrom(TPad::Class())) {
+      DecimateOverlappingMarkers(static_cast<TPad*>(obj));
+      continue;
+    }
+    // error bars, lines and areas of the other graph types depend on every single point
+    if (obj->IsA() != TGraph::Class()) continue;
+    string drawingOptions = next.GetOption();
+    std::transform(drawingOptions.begin(), drawingOptions.end(), drawingOptions.begin(), ::toupper);
+    if (drawingOptions.find('P') == string::npos || drawingOptions.find_first_of("LCFB") != string::npos) continue;
+    auto graph = static_cast<TGraph*>(obj);
+    // with transparent markers overlaps are visible
+    if (auto color = gROOT->GetColor(graph->GetMarkerColor()); color && color->GetAlpha() < 1.) continue;
+    DecimateMarkers(graph, pad);
+  }
+}
+
+//**************************************************************************************************
+/**
+ * Keeps only the first marker of a graph per pixel of the pad (occupancy grid).
+ */
+//**************************************************************************************************
+void PlotPainter::DecimateMarkers(TGraph* graph, TPad* pad)
+{
+  std::unordered_set<int64_t> occupiedPixels;
+  occupiedPixels.reserve(graph->GetN());
+  const double_t* x = graph->GetX();
+  const double_t* y = graph->GetY();
+  vector<int32_t> points;
+  points.reserve(graph->GetN());
+  for (int32_t i = 0; i < graph->GetN(); ++i) {
+    if ((pad->GetLogx() && x[i] <= 0.) || (pad->GetLogy() && y[i] <= 0.)) {
+      points.push_back(i);
+      continue;
+    }
+    int64_t pixelX = pad->XtoAbsPixel((pad->GetLogx()) ? TMath::Log10(x[i]) : x[i]);
+    int64_t pixelY = pad->YtoAbsPixel((pad->GetLogy()) ? TMath::Log10(y[i]) : y[i]);
+    if (occupiedPixels.insert((pixelX << 32) | (pixelY & 0xffffffff)).second) {
+      points.push_back(i);
+    }
+  }
+  SelectGraphPoints(graph, points);
+}
+
+//**************************************************************************************************
+/**
+ * Reduces a graph drawn as line, band or boxes to the first, last, minimum and maximum point within each pixel column
+ * of the pad as well as the points with the lowest and highest edge of their error band, which results in the same rasterized line and envelope.
+ */
+//**************************************************************************************************
+void PlotPainter::DecimateLine(TGraph* graph, TPad* pad)
+{
+  const double_t* x = graph->GetX();
+  const double_t* y = graph->GetY();
+  const double_t* eyLow = graph->GetEYlow() ? graph->GetEYlow() : graph->GetEY();
+  const double_t* eyHigh = graph->GetEYhigh() ? graph->GetEYhigh() : graph->GetEY();
+  auto lowEdge = [&](int32_t i) { return y[i] - (eyLow ? eyLow[i] : 0.); };
+  auto highEdge = [&](int32_t i) { return y[i] + (eyHigh ? eyHigh[i] : 0.); };
+  vector<int32_t> points;
+  points.reserve(graph->GetN());
+
+  int32_t first{}, last{}, min{}, max{}, minLow{}, maxHigh{};
+  optional<int32_t> curColumn;
+  auto flushColumn = [&]() {
+    array<int32_t, 6> columnPoints{first, min, max, minLow, maxHigh, last};
+    std::sort(columnPoints.begin(), columnPoints.end());
+    std::unique_copy(columnPoints.begin(), columnPoints.end(), std::back_inserter(points));
+  };
+  for (int32_t i = 0; i < graph->GetN(); ++i) {
+    optional<int32_t> column;
+    if (!(pad->GetLogx() && x[i] <= 0.)) {
+      column = pad->XtoAbsPixel((pad->GetLogx()) ? TMath::Log10(x[i]) : x[i]);
+    }
+    if (i > 0 && column && column == curColumn) {
+      if (y[i] < y[min]) min = i;
+      if (y[i] > y[max]) max = i;
+      if (lowEdge(i) < lowEdge(minLow)) minLow = i;
+      if (highEdge(i) > highEdge(maxHigh)) maxHigh = i;
+      last = i;
+      continue;
+    }
+    if (i > 0) flushColumn();
+    first = last = min = max = minLow = maxHigh = i;
+    curColumn = column;
+  }
+  if (graph->GetN()) flushColumn();
+  SelectGraphPoints(graph, points);
+}
+
+//**************************************************************************************************
+/**
+ * Keeps only the specified (ascending) points of the graph including their errors.
+ */
+//**************************************************************************************************
+void PlotPainter::SelectGraphPoints(TGraph* graph, const vector<int32_t>& points)
+{
+  const int32_t nPoints = static_cast<int32_t>(points.size());
+  if (nPoints == graph->GetN()) return;
+  for (double_t* values : {graph->GetX(), graph->GetY(), graph->GetEX(), graph->GetEY(),
+                           graph->GetEXlow(), graph->GetEXhigh(), graph->GetEYlow(), graph->GetEYhigh()}) {
+    if (!values) continue;
+    for (int32_t i = 0; i < nPoints; ++i) {
+      values[i] = values[points[i]];
+    }
+  }
+  DEBUG("Reduced graph {} from {} to {} points.", graph->GetName(), graph->GetN(), nPoints);
+  graph->Set(nPoints);
+}
+
 //**************************************************************************************************
 /**
  * Returns actual dimensions in pixel of the text with latex formatting.
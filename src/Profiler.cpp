@@ -0,0 +1,264 @@
+/*
+ ******************************************************************************************
+ * --------------------------------------- SciRooPlot -------------------------------------
+ * Copyright (c) 2019-2026 Mario Krüger
+ * Contact: mario.kruger@cern.ch
+ * For a full list of contributors please see doc/CONTRIBUTORS.md.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation in version 3 (or later) of the License.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * The GNU General Public License can be found here: <https://www.gnu.org/licenses/>.
+ ******************************************************************************************
+ */
+
+#include "SciRooPlot/Profiler.h"
+
+#include "SciRooPlot/Helpers.h"
+#include "SciRooPlot/Logging.h"
+
+#include <TSystem.h>
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace SciRooPlot
+{
+namespace
+{
+thread_local int32_t gScopeDepth{};
+
+uint32_t thread_index()
+{
+  static std::atomic<uint32_t> nThreads{};
+  thread_local uint32_t index = nThreads++;
+  return index;
+}
+
+string json_escape(const string& str)
+{
+  string escaped;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+    } else {
+      escaped += c;
+    }
+  }
+  return escaped;
+}
+}  // namespace
+
+Profiler& Profiler::Get()
+{
+  static Profiler profiler;
+  return profiler;
+}
+
+//**************************************************************************************************
+/**
+ * Enables or disables the profiler for the specified owner. Returns false if the profiler is already enabled by another owner.
+ */
+//**************************************************************************************************
+bool Profiler::Enable(const void* owner, bool enable, const string& traceFile)
+{
+  const void* currentOwner = owner;
+  if (!enable) {
+    mOwner.compare_exchange_strong(currentOwner, nullptr);
+    return true;
+  }
+  currentOwner = nullptr;
+  if (!mOwner.compare_exchange_strong(currentOwner, owner) && currentOwner != owner) return false;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTraceFile = traceFile;
+  }
+  // stages recorded for a previous owner are discarded
+  if (!currentOwner) Reset();
+  return true;
+}
+
+//**************************************************************************************************
+/**
+ * Starts measuring a stage.
+ */
+//**************************************************************************************************
+Profiler::Scope::Scope(const char* stage, const string& item) : mStage(stage), mIsActive(Profiler::Get().IsEnabled())
+{
+  if (!mIsActive) return;
+  mItem = item;
+  ++gScopeDepth;
+  mStartMemory = GetResidentMemory();
+  mStart = std::chrono::steady_clock::now();
+}
+
+//**************************************************************************************************
+/**
+ * Stops measuring a stage and records it.
+ */
+//**************************************************************************************************
+Profiler::Scope::~Scope()
+{
+  if (!mIsActive) return;
+  auto end = std::chrono::steady_clock::now();
+  int64_t residentMemory = GetResidentMemory();
+  --gScopeDepth;
+  auto& profiler = Profiler::Get();
+  using std::chrono::microseconds;
+  profiler.Record({mStage,
+                   std::move(mItem),
+                   std::chrono::duration_cast<microseconds>(mStart - profiler.mOrigin).count(),
+                   std::chrono::duration_cast<microseconds>(end - mStart).count(),
+                   residentMemory - mStartMemory,
+                   residentMemory,
+                   thread_index(),
+                   gScopeDepth});
+}
+
+//**************************************************************************************************
+/**
+ * Resident memory of the process in kB.
+ */
+//**************************************************************************************************
+int64_t Profiler::GetResidentMemory()
+{
+  ProcInfo_t procInfo;
+  gSystem->GetProcInfo(&procInfo);
+  return procInfo.fMemResident;
+}
+
+void Profiler::Record(event_t event)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mEvents.push_back(std::move(event));
+}
+
+//**************************************************************************************************
+/**
+ * Discards all recorded stages.
+ */
+//**************************************************************************************************
+void Profiler::Reset()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mEvents.clear();
+  mOrigin = std::chrono::steady_clock::now();
+}
+
+//**************************************************************************************************
+/**
+ * Prints the summary of all stages recorded so far, writes them to the trace file (if specified) and resets the profiler.
+ * Nothing is done unless the profiler is enabled by the specified owner.
+ */
+//**************************************************************************************************
+void Profiler::Report(const void* owner)
+{
+  if (mOwner.load() != owner) return;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    PrintSummary();
+    if (!mTraceFile.empty()) WriteTrace();
+  }
+  Reset();
+}
+
+//**************************************************************************************************
+/**
+ * Prints time and memory spent in each stage as well as the most expensive plots and data sources.
+ */
+//**************************************************************************************************
+void Profiler::PrintSummary() const
+{
+  if (mEvents.empty()) return;
+  struct summary_t {
+    int32_t depth{};
+    uint32_t calls{};
+    int64_t duration{};
+    int64_t maxDuration{};
+    int64_t memory{};
+  };
+  // stages are listed in the order they were first entered
+  vector<std::pair<string, summary_t>> stages;
+  std::map<std::pair<string, string>, int64_t> items;  // stage, item -> duration
+  int64_t peakMemory{};
+  vector<const event_t*> orderedEvents;
+  for (const auto& event : mEvents) {
+    orderedEvents.push_back(&event);
+  }
+  std::stable_sort(orderedEvents.begin(), orderedEvents.end(), [](const auto* a, const auto* b) { return a->start < b->start; });
+  for (const auto* event : orderedEvents) {
+    auto stage = std::find_if(stages.begin(), stages.end(), [&](const auto& entry) { return entry.first == event->stage; });
+    if (stage == stages.end()) {
+      stages.push_back({event->stage, {event->depth}});
+      stage = std::prev(stages.end());
+    }
+    auto& summary = stage->second;
+    summary.depth = std::min(summary.depth, event->depth);
+    ++summary.calls;
+    summary.duration += event->duration;
+    summary.maxDuration = std::max(summary.maxDuration, event->duration);
+    summary.memory += event->memory;
+    if (!event->item.empty()) items[{event->stage, event->item}] += event->duration;
+    peakMemory = std::max(peakMemory, event->residentMemory);
+  }
+
+  INFO("=================================== Profile ===================================");
+  INFO("{:<30} {:>7} {:>10} {:>10} {:>12}", "stage", "calls", "time [s]", "max [s]", "memory [MB]");
+  for (const auto& [stage, summary] : stages) {
+    INFO("{:<30} {:>7} {:>10.3f} {:>10.3f} {:>+12.1f}", string(2 * summary.depth, ' ') + stage, summary.calls, summary.duration * 1e-6, summary.maxDuration * 1e-6, summary.memory / 1024.);
+  }
+  if (!items.empty()) {
+    vector<std::pair<std::pair<string, string>, int64_t>> slowestItems(items.begin(), items.end());
+    std::sort(slowestItems.begin(), slowestItems.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (slowestItems.size() > 10) slowestItems.resize(10);
+    INFO("Most time consuming plots and data sources:");
+    for (const auto& [item, duration] : slowestItems) {
+      INFO(" - {:.3f} s {} ({})", duration * 1e-6, item.second, item.first);
+    }
+  }
+  INFO("Peak resident memory: {:.1f} MB.", peakMemory / 1024.);
+  INFO("===============================================================================");
+}
+
+//**************************************************************************************************
+/**
+ * Writes the recorded stages in the Chrome trace event format, which can be viewed for instance with https://ui.perfetto.dev.
+ */
+//**************************************************************************************************
+void Profiler::WriteTrace() const
+{
+  std::ofstream traceFile(expand_path(mTraceFile));
+  if (!traceFile) {
+    ERROR("Cannot write trace file {}.", mTraceFile);
+    return;
+  }
+  int32_t pid = gSystem->GetPid();
+  traceFile << "{\"traceEvents\": [\n";
+  bool isFirst = true;
+  for (const auto& event : mEvents) {
+    traceFile << (isFirst ? "" : ",\n");
+    isFirst = false;
+    traceFile << fmt::format(R"({{"name": "{}", "cat": "SciRooPlot", "ph": "X", "ts": {}, "dur": {}, "pid": {}, "tid": {}, "args": {{"item": "{}", "memory_kB": {}}}}})",
+                             json_escape(event.stage), event.start, event.duration, pid, event.thread, json_escape(event.item), event.memory);
+    traceFile << fmt::format(",\n" R"({{"name": "resident memory", "ph": "C", "ts": {}, "pid": {}, "args": {{"MB": {:.1f}}}}})", event.start + event.duration, pid, event.residentMemory / 1024.);
+  }
+  traceFile << "\n]}\n";
+  INFO("Wrote trace of the plot generation to {}.", mTraceFile);
+}
+
+}  // end namespace SciRooPlot
@@ -20,22 +20,28 @@
 #include "SciRooPlot/Plot.h"
 #include "SciRooPlot/PlotManager.h"
 
+#include <TAxis.h>
 #include <TDirectory.h>
 #include <TEnum.h>
 #include <TEnumConstant.h>
 #include <TGraphErrors.h>
 #include <TH1.h>
 #include <TH2.h>
+#include <TROOT.h>
 #include <TSystem.h>
 
 #include <pybind11/functional.h>
+#include <pybind11/numpy.h>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
 #include <math.h>
+#include <algorithm>
+#include <array>
 #include <numeric>
 #include <optional>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <utility>
 #include <vector>
@@ -100,6 +106,9 @@ PYBIND11_MODULE(SciRooPlot, m)
   py::list path = sys.attr("path");
   path.insert(0, SCIROOPLOT_ROOT_PYTHON_DIR);
 
+  // long-running calls release the GIL, so managers may open files and register objects with ROOT from several python threads
+  ROOT::EnableThreadSafety();
+
   exportLogging(m);
   exportDrawingOptions(m);
   exportRootConstants(m);
@@ -145,6 +154,68 @@ void exportRootConstants(py::module_& m)
   }
 }
 
+namespace
+{
+//**************************************************************************************************
+/**
+ * Checks if the object is a pandas DataFrame or pyarrow Table.
+ */
+//**************************************************************************************************
+bool is_table(const py::object& obj)
+{
+  return py::hasattr(obj, "column_names") || (py::hasattr(obj, "columns") && py::hasattr(obj, "to_numpy"));
+}
+
+//**************************************************************************************************
+/**
+ * Columns of a pandas DataFrame or pyarrow Table. Contiguous numeric columns are used in place and kept alive by the manager,
+ * other columns are converted to double once and non-numeric columns are skipped.
+ */
+//**************************************************************************************************
+PlotManager::table_t get_table_columns(const py::object& table)
+{
+  py::module_ np = py::module_::import("numpy");
+  bool isArrow = py::hasattr(table, "column_names");
+  py::list columnNames = (isArrow) ? py::list(table.attr("column_names")) : py::list(table.attr("columns"));
+  PlotManager::table_t columns;
+  for (const auto& columnName : columnNames) {
+    string name = py::str(columnName);
+    py::object values = (isArrow) ? table.attr("column")(columnName).attr("to_numpy")() : table[columnName].attr("to_numpy")();
+    py::array array = np.attr("ascontiguousarray")(values);
+    if (!py::isinstance<py::array_t<double>>(array) && !py::isinstance<py::array_t<float>>(array) && !py::isinstance<py::array_t<int64_t>>(array) && !py::isinstance<py::array_t<int32_t>>(array) && !py::isinstance<py::array_t<bool>>(array)) {
+      try {
+        array = np.attr("ascontiguousarray")(values, arg("dtype") = "float64");
+      } catch (const py::error_already_set&) {
+        WARNING("Skipping non-numeric column {}.", name);
+        continue;
+      }
+    }
+
+    PlotManager::column_t column;
+    // the column data are never modified, but RVec only adopts non-const memory
+    void* data = const_cast<void*>(array.data());
+    auto size = static_cast<size_t>(array.size());
+    if (py::isinstance<py::array_t<double>>(array)) {
+      column.values = ROOT::RVec<Double_t>(static_cast<Double_t*>(data), size);
+    } else if (py::isinstance<py::array_t<float>>(array)) {
+      column.values = ROOT::RVec<Float_t>(static_cast<Float_t*>(data), size);
+    } else if (py::isinstance<py::array_t<int64_t>>(array)) {
+      column.values = ROOT::RVec<Long64_t>(static_cast<Long64_t*>(data), size);
+    } else if (py::isinstance<py::array_t<int32_t>>(array)) {
+      column.values = ROOT::RVec<Int_t>(static_cast<Int_t*>(data), size);
+    } else {
+      column.values = ROOT::RVec<Bool_t>(static_cast<Bool_t*>(data), size);
+    }
+    column.owner = std::shared_ptr<void>(new py::object(array), [](void* obj) {
+      py::gil_scoped_acquire acquire;
+      delete static_cast<py::object*>(obj);
+    });
+    columns[name] = std::move(column);
+  }
+  return columns;
+}
+}  // namespace
+
 void exportPlotManager(py::module_& m)
 {
   py::class_<PlotManager>(m, "PlotManager")
@@ -152,17 +223,42 @@ void exportPlotManager(py::module_& m)
     .def("AddDataSource", overload_cast<const string&, const vector<string>&>(&PlotManager::AddDataSource), arg("dataSource"), arg("inputFiles"))
     .def("AddDataSource", overload_cast<const string&, const string&>(&PlotManager::AddDataSource), arg("dataSource"), arg("inputFile"))
     .def("AddDataSource", [](PlotManager& self, const std::string& dataSource, py::list objs) { py::module_ ROOT = py::module_::import("ROOT"); py::object addressof = ROOT.attr("addressof"); std::vector<TObject*> v; for (auto o : objs) v.push_back(reinterpret_cast<TObject*>(addressof(o).cast<std::uintptr_t>())); self.AddDataSource(dataSource, v); }, py::arg("dataSource"), py::arg("inputData"))
-    .def("AddDataSource", [](PlotManager& self, const std::string& dataSource, py::object obj) { py::module_ ROOT = py::module_::import("ROOT"); py::object addressof = ROOT.attr("addressof"); auto ptr = reinterpret_cast<TObject*>(addressof(obj).cast<std::uintptr_t>()); self.AddDataSource(dataSource, ptr); }, py::arg("dataSource"), py::arg("inputData"))
+    .def("AddDataSource", [](PlotManager& self, const std::string& dataSource, py::object obj, const optional<string>& tableName) { if (is_table(obj)) { self.AddDataSource(dataSource, tableName.value_or(dataSource), get_table_columns(obj)); return; } py::module_ ROOT = py::module_::import("ROOT"); py::object addressof = ROOT.attr("addressof"); auto ptr = reinterpret_cast<TObject*>(addressof(obj).cast<std::uintptr_t>()); self.AddDataSource(dataSource, ptr); }, py::arg("dataSource"), py::arg("inputData"), py::arg("tableName") = nullopt)
     .def("SaveDataSources", &PlotManager::SaveDataSources, arg("file") = vector<string>{})
-    .def("LoadDataSources", &PlotManager::LoadDataSources, arg("file") = vector<string>{})
+    .def("LoadDataSources", &PlotManager::LoadDataSources, arg("file") = vector<string>{}, py::call_guard<py::gil_scoped_release>())
     .def("AddPlot", &PlotManager::AddPlot, arg("plot"))
     .def("AddBasePlot", &PlotManager::AddBasePlot, arg("basePlot"))
     .def("AddColorOverview", &PlotManager::AddColorOverview, arg("name"), arg("group"), arg("colors") = vector<int32_t>{})
     .def("ListPlots", &PlotManager::ListPlots)
-    .def("LoadPlots", &PlotManager::LoadPlots, arg("name") = ".+", arg("group") = ".+", arg("file") = vector<string>{})
-    .def("SavePlots", &PlotManager::SavePlots, arg("name") = ".+", arg("group") = ".+", arg("file") = vector<string>{})
-    .def("GeneratePlots", &PlotManager::GeneratePlots, arg("mode") = "show", arg("name") = ".+", arg("group") = ".+")
+    .def("RenderToBuffer", [](PlotManager& self, const string& name, const string& group, const string& format) {
+      string buffer;
+      {
+        py::gil_scoped_release release;
+        buffer = self.RenderToBuffer(name, group, format);
+      }
+      return py::bytes(buffer); }, arg("name"), arg("group"), arg("format") = "png")
+    .def("LoadPlots", &PlotManager::LoadPlots, arg("name") = ".+", arg("group") = ".+", arg("file") = vector<string>{}, py::call_guard<py::gil_scoped_release>())
+    .def("SavePlots", &PlotManager::SavePlots, arg("name") = ".+", arg("group") = ".+", arg("file") = vector<string>{}, py::call_guard<py::gil_scoped_release>())
+    .def("GeneratePlots", &PlotManager::GeneratePlots, arg("mode") = "show", arg("name") = ".+", arg("group") = ".+", py::call_guard<py::gil_scoped_release>())
+    .def("GeneratePlotsAsync", [](py::object self, const string& mode, const string& name, const string& group) {
+      // the plots are generated in a background thread that does not hold the GIL, the returned concurrent.futures.Future completes when they are done
+      if (mode == "show") throw py::value_error("Interactive mode cannot run in the background.");
+      py::object executor = py::module_::import("concurrent.futures").attr("ThreadPoolExecutor")(1);
+      py::object future = executor.attr("submit")(self.attr("GeneratePlots"), mode, name, group);
+      executor.attr("shutdown")(arg("wait") = false);
+      return future; }, arg("mode") = "pdf", arg("name") = ".+", arg("group") = ".+")
+    .def("WatchPlots", [](PlotManager& self, const string& mode, const string& name, const string& group) {
+      {
+        py::gil_scoped_release release;
+        self.WatchPlots(mode, name, group);
+      }
+      // watching is stopped by SIGINT (e.g. interrupting the notebook kernel), which is passed on as KeyboardInterrupt
+      if (PyErr_CheckSignals() != 0) throw py::error_already_set(); }, arg("mode") = "show", arg("name") = ".+", arg("group") = ".+")
     .def("SetOutputDirectory", &PlotManager::SetOutputDirectory, arg("path"))
+    .def("SetDecimateVectorMarkers", &PlotManager::SetDecimateVectorMarkers, arg("decimate") = true)
+    .def("SetIncrementalBuild", &PlotManager::SetIncrementalBuild, arg("incremental") = true)
+    .def("SetProfiling", &PlotManager::SetProfiling, arg("profile") = true, arg("traceFile") = "")
+    .def("SetLoadReport", &PlotManager::SetLoadReport, arg("report") = true, arg("sortBy") = "time")
     .def("SaveProject", &PlotManager::SaveProject)
     .def_static("MakeBasePlot", overload_cast<const string&, double_t>(&PlotManager::MakeBasePlot), arg("name") = "1d", arg("screenResolution") = 100);
 }
@@ -325,6 +421,7 @@ void exportData(py::module_& m)
     .def("RebinY", &Data::RebinY, arg("nGroup"), ref_int)
     .def("RebinXY", &Data::RebinXY, arg("nGroupX"), arg("nGroupY"), ref_int)
     .def("Smooth", &Data::Smooth, arg("nIterSmooth") = 1, ref_int)
+    .def("Decimate", &Data::Decimate, arg("decimate") = true, ref_int)
     .def("Project", overload_cast<vector<uint8_t>, vector<tuple<uint8_t, double_t, double_t>>, optional<bool>>(&Data::Project), arg("dims"), arg("ranges") = vector<tuple<uint8_t, double_t, double_t>>{}, arg("isUserCoord") = nullopt, ref_int)
     .def("ProjectX", &Data::ProjectX, arg("startY") = 0, arg("endY") = -1, arg("isUserCoord") = nullopt, ref_int)
     .def("ProjectY", &Data::ProjectY, arg("startX") = 0, arg("endX") = -1, arg("isUserCoord") = nullopt, ref_int)
@@ -343,7 +440,8 @@ void exportData(py::module_& m)
     .def("Define", &Data::Define, arg("key"), arg("value"), ref_int)
     .def("Filter", &Data::Filter, arg("filter"), ref_int)
     .def("Entries", overload_cast<uint32_t>(&Data::Entries), arg("nEntries"), ref_int)
-    .def("Entries", overload_cast<uint32_t, uint32_t>(&Data::Entries), arg("entryMin"), arg("entryMax"), ref_int);
+    .def("Entries", overload_cast<uint32_t, uint32_t>(&Data::Entries), arg("entryMin"), arg("entryMax"), ref_int)
+    .def("Sparse", &Data::Sparse, arg("sparse") = true, ref_int);
 }
 
 void exportRatio(py::module_& m)
@@ -399,6 +497,7 @@ void exportRatio(py::module_& m)
     .def("RebinY", [](Ratio& self, uint16_t n) -> Ratio& { return self.RebinY(n); }, arg("nGroup"), ref_int)
     .def("RebinXY", [](Ratio& self, uint16_t x, uint16_t y) -> Ratio& { return self.RebinXY(x, y); }, arg("nGroupX"), arg("nGroupY"), ref_int)
     .def("Smooth", [](Ratio& self, uint16_t n = 1) -> Ratio& { return self.Smooth(n); }, arg("nIterSmooth") = 1, ref_int)
+    .def("Decimate", [](Ratio& self, bool b) -> Ratio& { return self.Decimate(b); }, arg("decimate") = true, ref_int)
     .def("Numer", &Ratio::Numer, ref_int)
     .def("Denom", &Ratio::Denom, ref_int)
     .def("Project", overload_cast<vector<uint8_t>, vector<tuple<uint8_t, double_t, double_t>>, optional<bool>>(&Ratio::Project), arg("dims"), arg("ranges") = vector<tuple<uint8_t, double_t, double_t>>{}, arg("isUserCoord") = nullopt, ref_int)
@@ -419,7 +518,8 @@ void exportRatio(py::module_& m)
     .def("Define", &Ratio::Define, arg("key"), arg("value"), ref_int)
     .def("Filter", &Ratio::Filter, arg("filter"), ref_int)
     .def("Entries", overload_cast<uint32_t>(&Ratio::Entries), arg("nEntries"), ref_int)
-    .def("Entries", overload_cast<uint32_t, uint32_t>(&Ratio::Entries), arg("entryMin"), arg("entryMax"), ref_int);
+    .def("Entries", overload_cast<uint32_t, uint32_t>(&Ratio::Entries), arg("entryMin"), arg("entryMax"), ref_int)
+    .def("Sparse", &Ratio::Sparse, arg("sparse") = true, ref_int);
 }
 
 void exportAxis(py::module_& m)
@@ -557,97 +657,299 @@ void exportLegendEntry(py::module_& m)
     .def("SetTextSize", &LegendEntry::SetTextSize, arg("size"), ref_int);
 }
 
+namespace
+{
+//**************************************************************************************************
+/**
+ * Binning of one histogram axis. The bin index is computed directly for equidistant bins and via binary search for variable bins.
+ */
+//**************************************************************************************************
+struct axis_binning_t {
+  explicit axis_binning_t(const TAxis* axis)
+    : nBins(axis->GetNbins()), min(axis->GetXmin()), max(axis->GetXmax()), edges(axis->GetXbins()->GetSize() ? axis->GetXbins()->GetArray() : nullptr)
+  {
+  }
+  // same conventions and expression as TAxis::FindFixBin, so values on the bin edges end up in the same bin (NaN ends up in the overflow bin)
+  int32_t FindBin(double_t x) const
+  {
+    if (x < min) return 0;
+    if (!(x < max)) return nBins + 1;
+    if (edges) return static_cast<int32_t>(std::upper_bound(edges, edges + nBins + 1, x) - edges);
+    return std::min(1 + static_cast<int32_t>(nBins * (x - min) / (max - min)), nBins);
+  }
+  bool IsInRange(int32_t bin) const { return bin > 0 && bin <= nBins; }
+
+  int32_t nBins;
+  double_t min;
+  double_t max;
+  const double_t* edges;  // only for variable bins
+};
+
+//**************************************************************************************************
+/**
+ * Fills a one- or two-dimensional histogram (y = nullptr for 1D) with optional weights.
+ * Large inputs are split into chunks that are binned in parallel into partial histograms, which are then added to the bin contents and squared weights of the histogram.
+ * The sums of weights and weighted moments are accumulated per chunk as well, so the statistics (mean, rms) are the same as with TH1::Fill.
+ * Should be called with the GIL released.
+ */
+//**************************************************************************************************
+void fill_histogram(TH1* hist, const double_t* x, const double_t* y, const double_t* weights, int64_t n)
+{
+  const axis_binning_t xAxis(hist->GetXaxis());
+  const axis_binning_t yAxis(hist->GetYaxis());
+  const int64_t nCellsX = xAxis.nBins + 2;
+  const int64_t nCells = (y) ? nCellsX * (yAxis.nBins + 2) : nCellsX;
+
+  // starting threads only pays off for large inputs
+  constexpr int64_t minChunkSize = 1 << 20;
+  const int64_t nThreads = std::clamp<int64_t>(n / minChunkSize, 1, std::max(1u, std::thread::hardware_concurrency()));
+  vector<vector<double_t>> sumw(nThreads, vector<double_t>(nCells));
+  vector<vector<double_t>> sumw2((weights) ? nThreads : 0, vector<double_t>(nCells));
+  // sumw, sumw2, sumwx, sumwx2 (and sumwy, sumwy2, sumwxy for 2D) in the order of TH1::GetStats
+  vector<std::array<double_t, 7>> moments(nThreads);
+  const bool statOverflows = hist->GetStatOverflowsBehaviour();
+
+  auto fillChunk = [&](int64_t chunk) {
+    const int64_t begin = n * chunk / nThreads;
+    const int64_t end = n * (chunk + 1) / nThreads;
+    auto& chunkSumw = sumw[chunk];
+    auto& chunkMoments = moments[chunk];
+    // bin indices of a block of values are computed in a separate loop, which the compiler can vectorize for equidistant bins
+    constexpr int64_t blockSize = 1024;
+    std::array<int64_t, blockSize> cells;
+    std::array<bool, blockSize> inRange;
+    for (int64_t blockBegin = begin; blockBegin < end; blockBegin += blockSize) {
+      const int64_t blockSizeCur = std::min(blockSize, end - blockBegin);
+      for (int64_t i = 0; i < blockSizeCur; ++i) {
+        cells[i] = xAxis.FindBin(x[blockBegin + i]);
+        inRange[i] = xAxis.IsInRange(static_cast<int32_t>(cells[i]));
+      }
+      if (y) {
+        for (int64_t i = 0; i < blockSizeCur; ++i) {
+          const int32_t yBin = yAxis.FindBin(y[blockBegin + i]);
+          cells[i] += nCellsX * yBin;
+          inRange[i] = inRange[i] && yAxis.IsInRange(yBin);
+        }
+      }
+      // like TH1::Fill, values in under- and overflow bins do not contribute to the statistics by default
+      for (int64_t i = 0; i < blockSizeCur; ++i) {
+        if (!inRange[i] && !statOverflows) continue;
+        const double_t weight = (weights) ? weights[blockBegin + i] : 1.;
+        const double_t xValue = x[blockBegin + i];
+        chunkMoments[0] += weight;
+        chunkMoments[1] += weight * weight;
+        chunkMoments[2] += weight * xValue;
+        chunkMoments[3] += weight * xValue * xValue;
+        if (y) {
+          const double_t yValue = y[blockBegin + i];
+          chunkMoments[4] += weight * yValue;
+          chunkMoments[5] += weight * yValue * yValue;
+          chunkMoments[6] += weight * xValue * yValue;
+        }
+      }
+      if (weights) {
+        auto& chunkSumw2 = sumw2[chunk];
+        for (int64_t i = 0; i < blockSizeCur; ++i) {
+          const double_t weight = weights[blockBegin + i];
+          chunkSumw[cells[i]] += weight;
+          chunkSumw2[cells[i]] += weight * weight;
+        }
+      } else {
+        for (int64_t i = 0; i < blockSizeCur; ++i) {
+          chunkSumw[cells[i]] += 1.;
+        }
+      }
+    }
+  };
+  vector<std::thread> threads;
+  for (int64_t chunk = 1; chunk < nThreads; ++chunk) {
+    threads.emplace_back(fillChunk, chunk);
+  }
+  fillChunk(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // statistics are taken before the bin contents change, since TH1::GetStats might otherwise re-compute them from the bins
+  const double_t entries = hist->GetEntries() + n;
+  std::array<double_t, TH1::kNstat> stats{};
+  hist->GetStats(stats.data());
+
+  if (weights && !hist->GetSumw2N()) hist->Sumw2();
+  double_t* histSumw2 = (hist->GetSumw2N()) ? hist->GetSumw2()->GetArray() : nullptr;
+  for (int64_t cell = 0; cell < nCells; ++cell) {
+    double_t cellSumw{};
+    double_t cellSumw2{};
+    for (int64_t chunk = 0; chunk < nThreads; ++chunk) {
+      cellSumw += sumw[chunk][cell];
+      cellSumw2 += (weights) ? sumw2[chunk][cell] : sumw[chunk][cell];
+    }
+    if (cellSumw == 0. && cellSumw2 == 0.) continue;
+    hist->AddBinContent(static_cast<int32_t>(cell), cellSumw);
+    if (histSumw2) histSumw2[cell] += cellSumw2;
+  }
+  // the moments of the filled values are added to the existing statistics of the histogram
+  for (const auto& chunkMoments : moments) {
+    for (size_t i = 0; i < chunkMoments.size(); ++i) {
+      stats[i] += chunkMoments[i];
+    }
+  }
+  hist->PutStats(stats.data());
+  hist->SetEntries(entries);
+}
+}  // namespace
+
 void exportPythonDataInterfaces(py::module_& m)
 {
-  auto graph = [](const std::string& name, const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& xerr, const std::vector<double>& yerr) {
-    const auto n = static_cast<int>(x.size());
+  // contiguous numpy arrays of doubles are read in place, other sequences (e.g. lists) are converted once
+  using array_t = py::array_t<double, py::array::c_style | py::array::forcecast>;
+  auto checkShape = [](const array_t& arr, const char* name) {
+    if (arr.ndim() != 1)
+      throw std::runtime_error(std::string(name) + " must be one-dimensional");
+  };
+  auto checkWeights = [=](const optional<array_t>& weights, int64_t n) {
+    if (!weights) return;
+    checkShape(*weights, "weights");
+    if (weights->size() != n)
+      throw std::runtime_error("weights must have same length as values");
+  };
+  // bins can be given as number of equidistant bins or as array of bin edges
+  auto getBinEdges = [=](const py::handle& bins) -> optional<array_t> {
+    if (py::isinstance<py::int_>(bins)) return nullopt;
+    auto edges = bins.cast<array_t>();
+    checkShape(edges, "bin edges");
+    if (edges.size() < 2)
+      throw std::runtime_error("at least two bin edges are required");
+    return edges;
+  };
+
+  auto graph = [=](const std::string& name, const array_t& x, const array_t& y, const optional<array_t>& xerr, const optional<array_t>& yerr) {
     static py::module_ ROOT = py::module_::import("ROOT");
     static py::object BindObject = ROOT.attr("BindObject");
     static py::object TGraphErrorsClass = ROOT.attr("TGraphErrors");
 
+    checkShape(x, "x");
+    checkShape(y, "y");
+    const auto n = x.size();
     if (y.size() != n)
       throw std::runtime_error("x and y must have same length");
-    if (!xerr.empty() && xerr.size() != n)
+    // empty errors are treated like missing errors
+    const double* xerrValues = (xerr && xerr->size()) ? xerr->data() : nullptr;
+    const double* yerrValues = (yerr && yerr->size()) ? yerr->data() : nullptr;
+    if (xerrValues && (xerr->ndim() != 1 || xerr->size() != n))
       throw std::runtime_error("xerr has wrong size");
-    if (!yerr.empty() && yerr.size() != n)
+    if (yerrValues && (yerr->ndim() != 1 || yerr->size() != n))
       throw std::runtime_error("yerr has wrong size");
 
-    auto* g = new TGraphErrors(n, x.data(), y.data(), xerr.empty() ? nullptr : xerr.data(), yerr.empty() ? nullptr : yerr.data());
+    auto* g = new TGraphErrors(static_cast<int>(n), x.data(), y.data(), xerrValues, yerrValues);
     g->SetName(name.data());
     return BindObject(reinterpret_cast<std::uintptr_t>(g), TGraphErrorsClass);
   };
 
-  auto histo = [&](const std::string& name, const std::vector<double>& v, int bins, py::object range) {
+  auto histo = [=](const std::string& name, const array_t& v, py::object bins, py::object range, const optional<array_t>& weights) {
     static py::module_ ROOT = py::module_::import("ROOT");
     static py::object BindObject = ROOT.attr("BindObject");
     static py::object TH1DClass = ROOT.attr("TH1D");
 
-    if (v.empty())
-      throw std::runtime_error("empty input");
-
-    double xmin, xmax;
+    checkShape(v, "values");
+    const double* values = v.data();
+    const int64_t n = v.size();
+    checkWeights(weights, n);
+    auto edges = getBinEdges(bins);
 
-    if (range.is_none()) {
-      auto [minIt, maxIt] = std::minmax_element(v.begin(), v.end());
-      xmin = *minIt;
-      xmax = *maxIt;
+    TH1D* h = nullptr;
+    if (edges) {
+      h = new TH1D(name.data(), "", static_cast<int>(edges->size() - 1), edges->data());
     } else {
-      auto r = range.cast<std::pair<double, double>>();
-      xmin = r.first;
-      xmax = r.second;
+      double xmin, xmax;
+      if (range.is_none()) {
+        if (n == 0)
+          throw std::runtime_error("empty input");
+        py::gil_scoped_release release;
+        auto [minIt, maxIt] = std::minmax_element(values, values + n);
+        xmin = *minIt;
+        xmax = *maxIt;
+      } else {
+        auto r = range.cast<std::pair<double, double>>();
+        xmin = r.first;
+        xmax = r.second;
+      }
+      h = new TH1D(name.data(), "", bins.cast<int>(), xmin, xmax);
+    }
+    {
+      py::gil_scoped_release release;
+      fill_histogram(h, values, nullptr, (weights) ? weights->data() : nullptr, n);
     }
-
-    auto* h = new TH1D(name.data(), "", bins, xmin, xmax);
-
-    for (double x : v)
-      h->Fill(x);
 
     return BindObject(reinterpret_cast<std::uintptr_t>(h), TH1DClass);
   };
 
-  auto histo2d = [&](const std::string& name, const std::vector<double>& x, const std::vector<double>& y, py::object bins, py::object range) {
+  auto histo2d = [=](const std::string& name, const array_t& x, const array_t& y, py::object bins, py::object range, const optional<array_t>& weights) {
     static py::module_ ROOT = py::module_::import("ROOT");
     static py::object BindObject = ROOT.attr("BindObject");
     static py::object TH2DClass = ROOT.attr("TH2D");
 
+    checkShape(x, "x");
+    checkShape(y, "y");
     if (x.size() != y.size())
       throw std::runtime_error("x and y must have same length");
 
-    int nx = 50, ny = 50;
-    double xmin, xmax, ymin, ymax;
-
-    auto [minxIt, maxxIt] = std::minmax_element(x.begin(), x.end());
-    auto [minyIt, maxyIt] = std::minmax_element(y.begin(), y.end());
-    xmin = *minxIt;
-    xmax = *maxxIt;
-    ymin = *minyIt;
-    ymax = *maxyIt;
+    const double* xValues = x.data();
+    const double* yValues = y.data();
+    const int64_t n = x.size();
+    checkWeights(weights, n);
 
+    // bins per axis are either a number of equidistant bins or bin edges
+    py::object xBins = py::int_(50);
+    py::object yBins = py::int_(50);
     if (!bins.is_none()) {
-      auto b = bins.cast<std::pair<int, int>>();
-      nx = b.first;
-      ny = b.second;
+      auto b = bins.cast<std::pair<py::object, py::object>>();
+      xBins = b.first;
+      yBins = b.second;
     }
+    auto xEdges = getBinEdges(xBins);
+    auto yEdges = getBinEdges(yBins);
 
+    double xmin{}, xmax{}, ymin{}, ymax{};
     if (!range.is_none()) {
       auto r = range.cast<std::pair<std::pair<double, double>, std::pair<double, double>>>();
       xmin = r.first.first;
       xmax = r.first.second;
       ymin = r.second.first;
       ymax = r.second.second;
+    } else if (!xEdges || !yEdges) {
+      if (n == 0)
+        throw std::runtime_error("empty input");
+      py::gil_scoped_release release;
+      auto [minxIt, maxxIt] = std::minmax_element(xValues, xValues + n);
+      auto [minyIt, maxyIt] = std::minmax_element(yValues, yValues + n);
+      xmin = *minxIt;
+      xmax = *maxxIt;
+      ymin = *minyIt;
+      ymax = *maxyIt;
     }
 
-    auto* h = new TH2D(name.c_str(), "", nx, xmin, xmax, ny, ymin, ymax);
-
-    for (size_t i = 0; i < x.size(); ++i)
-      h->Fill(x[i], y[i]);
+    TH2D* h = nullptr;
+    if (xEdges && yEdges) {
+      h = new TH2D(name.c_str(), "", static_cast<int>(xEdges->size() - 1), xEdges->data(), static_cast<int>(yEdges->size() - 1), yEdges->data());
+    } else if (xEdges) {
+      h = new TH2D(name.c_str(), "", static_cast<int>(xEdges->size() - 1), xEdges->data(), yBins.cast<int>(), ymin, ymax);
+    } else if (yEdges) {
+      h = new TH2D(name.c_str(), "", xBins.cast<int>(), xmin, xmax, static_cast<int>(yEdges->size() - 1), yEdges->data());
+    } else {
+      h = new TH2D(name.c_str(), "", xBins.cast<int>(), xmin, xmax, yBins.cast<int>(), ymin, ymax);
+    }
+    {
+      py::gil_scoped_release release;
+      fill_histogram(h, xValues, yValues, (weights) ? weights->data() : nullptr, n);
+    }
 
     h->SetName(name.c_str());
 
     return BindObject(reinterpret_cast<std::uintptr_t>(h), TH2DClass);
   };
 
-  m.def("graph", graph, py::arg("name"), py::arg("x"), py::arg("y"), py::arg("xerr") = std::vector<double>{}, py::arg("yerr") = std::vector<double>{});
-  m.def("histo", histo, py::arg("name"), py::arg("values"), py::arg("bins") = 100, py::arg("range") = py::none());
-  m.def("histo2d", histo2d, py::arg("name"), py::arg("x"), py::arg("y"), py::arg("bins") = py::none(), py::arg("range") = py::none());
+  m.def("graph", graph, py::arg("name"), py::arg("x"), py::arg("y"), py::arg("xerr") = py::none(), py::arg("yerr") = py::none());
+  m.def("histo", histo, py::arg("name"), py::arg("values"), py::arg("bins") = 100, py::arg("range") = py::none(), py::arg("weights") = py::none());
+  m.def("histo2d", histo2d, py::arg("name"), py::arg("x"), py::arg("y"), py::arg("bins") = py::none(), py::arg("range") = py::none(), py::arg("weights") = py::none());
 }